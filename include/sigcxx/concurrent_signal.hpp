@@ -0,0 +1,427 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file concurrent_signal.hpp
+ * @brief Header file for ConcurrentSignal class.
+ */
+
+#ifndef WIZTK_BASE_CONCURRENT_SIGNAL_HPP_
+#define WIZTK_BASE_CONCURRENT_SIGNAL_HPP_
+
+#include "sigcxx/sigcxx.hpp"
+#include "sigcxx/epoch.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace sigcxx {
+
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief A TokenNode used in ConcurrentSignal.
+ * @tparam ParamTypes
+ *
+ * Emission does not read tokens, it calls the delegates in a snapshot. The
+ * token keeps the connection to a BindingNode and removes itself from the
+ * signal when destroyed. Its closed mark is freed through EpochDomain, as
+ * snapshots still read it.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT ConcurrentToken : public SignalTokenNode {
+
+  friend class ConcurrentSignal<ParamTypes...>;
+
+ public:
+
+  typedef ConcurrentSignal<ParamTypes...> SignalType;
+  typedef Delegate<void(typename ArgRef<ParamTypes>::type..., SLOT)> DelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(ConcurrentToken);
+  ConcurrentToken() = delete;
+
+  ConcurrentToken(SignalType *signal, const DelegateType &delegate)
+      : SignalTokenNode(kTokenConcurrent), signal_(signal), delegate_(delegate),
+        barrier_(&signal->barrier_), closed_(EmissionBarrier::NewMark()) {}
+
+  ~ConcurrentToken() override {
+    EmissionBarrier::Close(closed_);
+    // Wait without the lock of the signal, a slot method running may connect.
+    // Never wait in a slot method: two threads each removing a connection in
+    // an emission would wait for each other.
+    if (!EmissionScope::IsEmitting()) barrier_->Wait();
+    if (nullptr != signal_) signal_->Erase(this);
+    EmissionBarrier::RetireMark(closed_);
+  }
+
+  bool IsBoundTo(const void *object, GenericMethodPointer method) const final {
+    return delegate_.IsBoundTo(object, method);
+  }
+
+  const DelegateType &delegate() const {
+    return delegate_;
+  }
+
+  const std::atomic<bool> *closed() const {
+    return closed_;
+  }
+
+ private:
+
+  SignalType *signal_;  // nullptr if already removed from the signal
+
+  DelegateType delegate_;
+
+  EmissionBarrier *barrier_;  // of the signal, kept after signal_ is cleared
+
+  std::atomic<bool> *closed_;  // read by snapshots, retired with the token
+
+};
+
+} // namespace internal
+
+/**
+ * @ingroup base
+ * @brief A signal which can be emitted from many threads without a lock
+ *
+ * Emit() takes no lock: it calls the delegates in an immutable snapshot of
+ * the connections. Connecting, disconnecting and blocking a connection take a
+ * mutex of the signal, build a new snapshot and publish it. The old snapshot
+ * is freed through internal::EpochDomain when no emission in any thread can
+ * still read it.
+ *
+ * Some differences from Signal:
+ *   - A snapshot is taken when Emit() starts, connections added in a slot
+ *     method (in this or another thread) are called from the next Emit().
+ *     Connections removed are skipped at once.
+ *   - The slot parameter is always nullptr, use a Connection to disconnect
+ *     in a slot method.
+ *   - No signal chaining and no positions.
+ *
+ * Removing a connection, including destroying its observer, makes emissions
+ * in all threads skip it. Outside slot methods it also waits until the
+ * emissions of this signal already running in other threads have returned,
+ * see internal::EmissionBarrier. The wait is in the destructor of Trackable,
+ * after the members of a derived observer are gone: call UnbindAllSignals()
+ * first in the destructor of an observer whose slot methods use its members.
+ *
+ * In a slot method of any ConcurrentSignal nothing is waited for, as two
+ * threads each removing a connection in an emission would wait for each
+ * other. A slot method can remove its own connection or destroy its own
+ * observer, but other threads may still be calling the connection removed:
+ * it must not destroy an observer which is called from other threads.
+ *
+ * Each change of the connections copies all delegates into a new snapshot,
+ * so connecting or disconnecting is O(n) and making n connections one by one
+ * is O(n^2). ConcurrentSignal suits signals emitted often from many threads
+ * with a few to some hundreds of connections changed rarely, use Signal with
+ * a lock for a large or frequently changed set of connections.
+ *
+ * @note Changing connections only takes the lock of the signal, the
+ * bindings in an observer are not protected: connections to the same
+ * observer must not be made, broken, or destroyed with the observer, from
+ * two threads at the same time. A slot method must not wait for a thread
+ * which is removing a connection of the signal calling it.
+ */
+template<typename ... ParamTypes>
+class WIZTK_EXPORT ConcurrentSignal : public Trackable {
+
+  friend class internal::ConcurrentToken<ParamTypes...>;
+
+ public:
+
+  typedef typename internal::ConcurrentToken<ParamTypes...>::DelegateType DelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(ConcurrentSignal);
+
+  ConcurrentSignal() = default;
+
+  /**
+   * @brief Destructor
+   *
+   * The signal must not be emitted in any thread any more.
+   */
+  ~ConcurrentSignal() final;
+
+  /**
+   * @brief Connect this signal to a slot method in a observer
+   */
+  template<typename T>
+  Connection Connect(T *obj, void (T::*method)(ParamTypes..., SLOT)) {
+    return Connect<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  /**
+   * @brief Connect this signal to a slot method with compatible parameter types
+   * @see Signal::Connect()
+   */
+  template<typename T, typename ... SlotParamTypes>
+  Connection Connect(T *obj, void (T::*method)(SlotParamTypes...));
+
+  /**
+   * @brief Disconnect all delegates to a method
+   */
+  template<typename T>
+  void DisconnectAll(T *obj, void (T::*method)(ParamTypes..., SLOT)) {
+    DisconnectAll<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  void DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...));
+
+  void DisconnectAll();
+
+  template<typename T>
+  bool IsConnectedTo(T *obj, void (T::*method)(ParamTypes..., SLOT)) const {
+    return IsConnectedTo<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  bool IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const;
+
+  int CountConnections() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<int>(tokens_.size());
+  }
+
+  bool empty() const {
+    return 0 == CountConnections();
+  }
+
+  /**
+   * @brief Emit this signal, can be called from any thread
+   */
+  void Emit(ParamTypes ... Args) {
+    Dispatch(Args...);
+  }
+
+  void operator()(ParamTypes ... Args) {
+    Emit(std::forward<ParamTypes>(Args)...);
+  }
+
+  /**
+   * @brief Block or unblock this signal
+   * @see Signal::Block()
+   */
+  void Block(bool blocked = true) {
+    blocked_.store(blocked, std::memory_order_relaxed);
+  }
+
+  void Unblock() {
+    Block(false);
+  }
+
+  bool IsBlocked() const {
+    return blocked_.load(std::memory_order_relaxed);
+  }
+
+ private:
+
+  typedef internal::ConcurrentToken<ParamTypes...> TokenType;
+
+  struct SnapshotEntry {
+    DelegateType delegate;
+    const std::atomic<bool> *closed;
+  };
+
+  /**
+   * @brief The delegates of the connections not blocked, never changed once
+   * published
+   */
+  typedef std::vector<SnapshotEntry> Snapshot;
+
+  void Dispatch(typename internal::ArgRef<ParamTypes>::type ... Args);
+
+  /**
+   * @brief Remove a token being destroyed
+   */
+  void Erase(TokenType *token);
+
+  /**
+   * @brief Remove the tokens matching the delegate and return them, called
+   * with the lock held
+   *
+   * The tokens returned are to be deleted after the lock is released.
+   */
+  std::vector<TokenType *> Take(const DelegateType *delegate);
+
+  /**
+   * @brief Build and publish a new snapshot of all connections, O(n), called
+   * with the lock held
+   */
+  void Publish();
+
+  void OnTokenBlocked(internal::SignalTokenNode *token) final;
+
+  static void DeleteSnapshot(void *snapshot) {
+    delete static_cast<Snapshot *>(snapshot);
+  }
+
+  mutable std::mutex mutex_;
+
+  /**
+   * @brief The tokens in the order of connecting, guarded by mutex_
+   */
+  std::vector<TokenType *> tokens_;
+
+  std::atomic<Snapshot *> snapshot_{nullptr};
+
+  std::atomic<bool> blocked_{false};
+
+  internal::EmissionBarrier barrier_;
+
+};
+
+// ConcurrentSignal implementation:
+
+template<typename ... ParamTypes>
+ConcurrentSignal<ParamTypes...>::~ConcurrentSignal() {
+  DisconnectAll();
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+Connection ConcurrentSignal<ParamTypes...>::Connect(T *obj, void (T::*method)(SlotParamTypes...)) {
+  static_assert(sizeof...(SlotParamTypes) == sizeof...(ParamTypes) + 1,
+                "The slot method must take the same number of parameters as the signal, plus a SLOT");
+
+  auto *record = internal::ConnectionRecord<TokenType>::New(this, DelegateType::FromMethod(obj, method));
+  auto *token = record->token();
+  auto *binding = record->binding();
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  Link(token, binding);
+  token->trackable = this;
+  PushBackBinding(obj, binding);
+
+  tokens_.push_back(token);
+  Publish();
+
+  return Connection(token);
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+void ConcurrentSignal<ParamTypes...>::DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...)) {
+  const DelegateType delegate = DelegateType::FromMethod(obj, method);
+  std::vector<TokenType *> tokens;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tokens = Take(&delegate);
+  }
+  for (TokenType *token : tokens) delete token;
+}
+
+template<typename ... ParamTypes>
+void ConcurrentSignal<ParamTypes...>::DisconnectAll() {
+  std::vector<TokenType *> tokens;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    tokens = Take(nullptr);
+  }
+  for (TokenType *token : tokens) delete token;
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+bool ConcurrentSignal<ParamTypes...>::IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const {
+  const DelegateType delegate = DelegateType::FromMethod(obj, method);
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (const TokenType *token : tokens_) {
+    if (token->delegate() == delegate) return true;
+  }
+  return false;
+}
+
+template<typename ... ParamTypes>
+void ConcurrentSignal<ParamTypes...>::Dispatch(typename internal::ArgRef<ParamTypes>::type ... Args) {
+  if (blocked_.load(std::memory_order_relaxed)) return;
+
+  internal::EpochGuard guard;
+  const Snapshot *snapshot = snapshot_.load(std::memory_order_acquire);
+  if (nullptr == snapshot) return;
+
+  internal::EmissionScope scope(&barrier_);
+  for (const SnapshotEntry &entry : *snapshot) {
+    if (internal::EmissionScope::IsClosed(entry.closed)) continue;  // being removed
+    entry.delegate.InvokeMethod(Args..., nullptr);
+  }
+}
+
+template<typename ... ParamTypes>
+void ConcurrentSignal<ParamTypes...>::Erase(TokenType *token) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Connections are usually removed in reverse order, search from the back:
+  for (size_t pos = tokens_.size(); pos > 0; pos--) {
+    if (tokens_[pos - 1] == token) {
+      tokens_.erase(tokens_.begin() + (pos - 1));
+      break;
+    }
+  }
+  Publish();
+}
+
+template<typename ... ParamTypes>
+std::vector<typename ConcurrentSignal<ParamTypes...>::TokenType *>
+ConcurrentSignal<ParamTypes...>::Take(const DelegateType *delegate) {
+  std::vector<TokenType *> taken;
+  size_t kept = 0;
+
+  for (TokenType *token : tokens_) {
+    if ((nullptr == delegate) || (token->delegate() == *delegate)) {
+      token->signal_ = nullptr;
+      taken.push_back(token);
+    } else {
+      tokens_[kept++] = token;
+    }
+  }
+  tokens_.resize(kept);
+
+  if (!taken.empty()) Publish();
+  return taken;
+}
+
+template<typename ... ParamTypes>
+void ConcurrentSignal<ParamTypes...>::Publish() {
+  Snapshot *snapshot = nullptr;
+
+  for (const TokenType *token : tokens_) {
+    if (token->blocked) continue;
+    if (nullptr == snapshot) {
+      snapshot = new Snapshot;
+      snapshot->reserve(tokens_.size());
+    }
+    snapshot->push_back(SnapshotEntry{token->delegate(), token->closed()});
+  }
+
+  Snapshot *old = snapshot_.exchange(snapshot, std::memory_order_acq_rel);
+  if (nullptr != old) internal::EpochDomain::Retire(old, &DeleteSnapshot);
+}
+
+template<typename ... ParamTypes>
+void ConcurrentSignal<ParamTypes...>::OnTokenBlocked(internal::SignalTokenNode * /* token */) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  Publish();
+}
+
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_CONCURRENT_SIGNAL_HPP_
@@ -196,6 +196,42 @@ class WIZTK_EXPORT Delegate<ReturnType(ParamTypes...)> {
     return Delegate(object, method);
   }
 
+  /**
+   * @brief Create a delegate from the given object and a member function
+   * pointer with compatible parameter types.
+   * @tparam T The object type
+   * @tparam MethodParamTypes Parameter types of the method, each one must be
+   *         able to be initialized from the corresponding one in ParamTypes
+   * @param object A pointer to an object
+   * @param method A pointer to a member function in class T
+   * @return A delegate object
+   *
+   * For example, a Delegate<void(std::string &)> can be created from a method
+   * taking a const std::string & or a std::string.
+   */
+  template<typename T, typename ... MethodParamTypes>
+  static inline Delegate FromMethod(T *object,
+                                    ReturnType (T::*method)(MethodParamTypes...)) {
+    typedef ReturnType (T::*TMethod)(MethodParamTypes...);
+    return Bind<T, TMethod>(object, method);
+  }
+
+  /**
+   * @brief Create a delegate from the given object and a const member function
+   * pointer with compatible parameter types.
+   * @tparam T The object type
+   * @tparam MethodParamTypes Parameter types of the method
+   * @param object A pointer to an object
+   * @param method A pointer to a member function in class T
+   * @return A delegate object
+   */
+  template<typename T, typename ... MethodParamTypes>
+  static inline Delegate FromMethod(T *object,
+                                    ReturnType (T::*method)(MethodParamTypes...) const) {
+    typedef ReturnType (T::*TMethod)(MethodParamTypes...) const;
+    return Bind<T, TMethod>(object, method);
+  }
+
   /**
    * @brief Create a delegate from the given function object.
    * @tparam T A type of function object.
@@ -363,6 +399,23 @@ class WIZTK_EXPORT Delegate<ReturnType(ParamTypes...)> {
     return reinterpret_cast<TFunction >(data_.pointer.function)(Args...);
   }
 
+  /**
+   * @brief Invoke the method bound to this delegate.
+   * @param Args
+   * @return
+   *
+   * This is the fast path of Invoke() which calls the method stub directly
+   * without checking whether a static function is bound.
+   *
+   * @note Only use this on a delegate created from a method or a function
+   * object, calling this on a delegate to a static function or an empty
+   * delegate will cause segment fault.
+   */
+  ReturnType InvokeMethod(ParamTypes... Args) const {
+    _ASSERT(nullptr != data_.object && nullptr != data_.method_stub);
+    return (*data_.method_stub)(data_.object, data_.pointer.method, Args...);
+  }
+
   /**
    * @brief Bool operator
    * @return True if pointer to a method is set, false otherwise
@@ -380,7 +433,9 @@ class WIZTK_EXPORT Delegate<ReturnType(ParamTypes...)> {
    * cause segment fault.  The bool operator will return false.
    */
   void Reset() {
-    memset(&data_, 0, sizeof(Data));
+    data_.object = nullptr;
+    data_.method_stub = nullptr;
+    data_.pointer.method = nullptr;
   }
 
   /**
@@ -415,6 +470,40 @@ class WIZTK_EXPORT Delegate<ReturnType(ParamTypes...)> {
         (data_.pointer.method == reinterpret_cast<internal::GenericMethodPointer>(method));
   }
 
+  /**
+   * @brief Compare this delegate to a member function with compatible parameter types.
+   * @tparam T
+   * @tparam MethodParamTypes
+   * @param object
+   * @param method
+   * @return
+   */
+  template<typename T, typename ... MethodParamTypes>
+  bool Equal(T *object, ReturnType(T::*method)(MethodParamTypes...)) const {
+    typedef ReturnType (T::*TMethod)(MethodParamTypes...);
+
+    return (data_.object == object) &&
+        (data_.method_stub == &MethodStub<T, TMethod>::invoke) &&
+        (data_.pointer.method == reinterpret_cast<internal::GenericMethodPointer>(method));
+  }
+
+  /**
+   * @brief Returns if this delegate is bound to the given method of an object.
+   * @tparam T
+   * @tparam TMethod
+   * @param object
+   * @param method
+   * @return
+   *
+   * Different from Equal(), this only compares the object and method pointer,
+   * the parameter types of the method are ignored.
+   */
+  template<typename T, typename TMethod>
+  bool IsBoundTo(T *object, TMethod method) const {
+    return (data_.object == object) &&
+        (data_.pointer.method == reinterpret_cast<internal::GenericMethodPointer>(method));
+  }
+
   /**
    * @brief Compare this delegate to a lambda.
    * @tparam T
@@ -464,8 +553,31 @@ class WIZTK_EXPORT Delegate<ReturnType(ParamTypes...)> {
     return kDelegateTypeMember;
   }
 
+  /**
+   * @brief Returns the object of a member delegate
+   */
+  void *object() const {
+    return data_.object;
+  }
+
+  /**
+   * @brief Returns the member function pointer of a member delegate
+   */
+  internal::GenericMethodPointer method() const {
+    return data_.pointer.method;
+  }
+
  private:
 
+  template<typename T, typename TMethod>
+  static inline Delegate Bind(T *object, TMethod method) {
+    Delegate delegate;
+    delegate.data_.object = object;
+    delegate.data_.method_stub = &MethodStub<T, TMethod>::invoke;
+    delegate.data_.pointer.method = reinterpret_cast<internal::GenericMethodPointer>(method);
+    return delegate;
+  }
+
   Data data_;
 
 };
@@ -0,0 +1,233 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file epoch.hpp
+ * @brief Header file for epoch based reclamation.
+ */
+
+#ifndef WIZTK_BASE_EPOCH_HPP_
+#define WIZTK_BASE_EPOCH_HPP_
+
+#include "sigcxx/macros.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace sigcxx {
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief Epoch based reclamation of objects read without locks
+ *
+ * A reader calls Enter() before it loads a shared pointer and Exit() after
+ * it's done with the object. A writer replaces the shared pointer and calls
+ * Retire() with the old object, which is freed once every thread that may
+ * still read it has called Exit().
+ *
+ * Each thread announces the global epoch it entered in. The global epoch
+ * only advances when all threads inside have seen the current one, an
+ * object retired in epoch e is freed when the global epoch reaches e + 2.
+ *
+ * Enter() and Exit() can be nested, they only touch the record of the
+ * calling thread. Retire() takes a lock.
+ */
+class WIZTK_EXPORT EpochDomain {
+
+ public:
+
+  EpochDomain() = delete;
+
+  static void Enter();
+
+  static void Exit();
+
+  /**
+   * @brief Free an object with the deleter when no reader can access it
+   *
+   * The object must be unreachable for new readers before this is called.
+   */
+  static void Retire(void *object, void (*deleter)(void *));
+
+  /**
+   * @brief Try to advance the epoch and free retired objects
+   */
+  static void Collect();
+
+  /**
+   * @brief Returns the number of retired objects not freed yet
+   */
+  static size_t CountRetired();
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief Enter the epoch domain in a scope
+ */
+class WIZTK_NO_EXPORT EpochGuard {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(EpochGuard);
+
+  EpochGuard() {
+    EpochDomain::Enter();
+  }
+
+  ~EpochGuard() {
+    EpochDomain::Exit();
+  }
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief Wait for the emissions of one signal in progress, so that a
+ * connection can be torn down while other threads are emitting
+ *
+ * Each emission is counted in one of two phases. Wait() waits for each
+ * phase to drain in turn while new emissions are counted in the other, so it
+ * returns once every emission started before the call has finished. Only the
+ * emissions of this signal are waited for. The counters are striped by
+ * thread, emitting in different threads does not write the same cache line.
+ *
+ * A connection being removed is marked closed first. An emission checks the
+ * mark before each slot method it calls: either it's counted before the
+ * mark was set and Wait() waits for it, or it sees the mark and skips the
+ * slot method.
+ *
+ * Wait() is only called outside emissions, of this or any other signal. A
+ * thread waiting in a slot method could wait for another thread which is
+ * waiting for it in turn, a connection removed there is only closed.
+ */
+class WIZTK_EXPORT EmissionBarrier {
+
+  friend class EmissionScope;
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(EmissionBarrier);
+
+  EmissionBarrier();
+
+  ~EmissionBarrier();
+
+  /**
+   * @brief Wait for the emissions started before, called outside emissions
+   */
+  void Wait();
+
+  /**
+   * @brief Create a closed mark for a connection
+   */
+  static std::atomic<bool> *NewMark() {
+    return new std::atomic<bool>(false);
+  }
+
+  /**
+   * @brief Mark a connection closed, emissions started later skip it
+   */
+  static void Close(std::atomic<bool> *mark) {
+    mark->store(true);
+  }
+
+  /**
+   * @brief Free a closed mark when no emission can read it
+   */
+  static void RetireMark(std::atomic<bool> *mark) {
+    EpochDomain::Retire(mark, &DeleteMark);
+  }
+
+ private:
+
+  static void DeleteMark(void *mark) {
+    delete static_cast<std::atomic<bool> *>(mark);
+  }
+
+  static constexpr size_t kStripes = 4;
+
+  /**
+   * @brief The counters of both phases used by some threads, on its own
+   * cache line
+   */
+  struct alignas(64) Stripe {
+    std::atomic<size_t> counters[2] = {};
+  };
+
+  /**
+   * @brief Returns the number of emissions in the phase, in all stripes
+   */
+  size_t Count(size_t phase) const;
+
+  std::atomic<size_t> phase_{0};
+
+  /**
+   * @brief kStripes stripes allocated aligned to a cache line, kept out of
+   * line so that the signals holding a barrier are not over-aligned
+   */
+  Stripe *stripes_;
+
+  std::mutex mutex_;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief Count an emission in an EmissionBarrier in a scope
+ *
+ * The scopes of a thread are linked so that a connection removed in a slot
+ * method knows it's in an emission, see IsEmitting().
+ */
+class WIZTK_EXPORT EmissionScope {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(EmissionScope);
+
+  explicit EmissionScope(EmissionBarrier *barrier);
+
+  ~EmissionScope();
+
+  /**
+   * @brief Returns if this thread is in the emission of any signal
+   */
+  static bool IsEmitting();
+
+  /**
+   * @brief Returns if the connection with the mark is being removed
+   */
+  static bool IsClosed(const std::atomic<bool> *mark) {
+    // Ordered after the counter increment, pairs with Close() and Wait()
+    return mark->load();
+  }
+
+ private:
+
+  std::atomic<size_t> *counter_;
+
+  EmissionScope *outer_;
+
+};
+
+} // namespace internal
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_EPOCH_HPP_
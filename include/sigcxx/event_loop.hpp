@@ -0,0 +1,122 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file event_loop.hpp
+ * @brief Header file for EventLoop class.
+ */
+
+#ifndef WIZTK_BASE_EVENT_LOOP_HPP_
+#define WIZTK_BASE_EVENT_LOOP_HPP_
+
+#include "sigcxx/executor.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+namespace sigcxx {
+
+/**
+ * @ingroup base
+ * @brief An Executor which runs tasks in the thread of its loop and sleeps
+ * when there's nothing to do
+ *
+ * Use it as the target of queued connections: any thread can post, the
+ * thread owning the loop calls Run(), RunOnce() or Drain().
+ *
+ * Post() is one atomic exchange while the loop is busy. The loop announces
+ * when it's going to sleep, and only then a posting thread takes the mutex to
+ * wake it up.
+ */
+class WIZTK_EXPORT EventLoop : public Executor {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(EventLoop);
+
+  EventLoop() = default;
+
+  /**
+   * @brief Destructor, tasks not run are discarded
+   */
+  ~EventLoop() override;
+
+  void Post(Task *task) override;
+
+  /**
+   * @brief Run tasks, and wait for more, until Quit() is called
+   */
+  void Run();
+
+  /**
+   * @brief Wait until there's a task or Quit() is called, then run the tasks
+   * in queue until it's empty or Quit() is called
+   * @return The number of tasks run, 0 if Quit() was called
+   *
+   * Returning 0 clears the quit, the next call waits again. A Quit() called
+   * while there are tasks to run is kept for the next call.
+   */
+  size_t RunOnce();
+
+  /**
+   * @brief Run at most max_items tasks in queue without waiting
+   * @return The number of tasks run
+   */
+  size_t Drain(size_t max_items = static_cast<size_t>(-1));
+
+  /**
+   * @brief Make Run() return after the task being run, may be called in any
+   * thread
+   *
+   * If the loop is not running, the next Run() or RunOnce() returns at
+   * once. Each Quit() is cleared by the call it ends.
+   */
+  void Quit();
+
+ private:
+
+  /**
+   * @brief Sleep until Post() or Quit() wakes the loop up, or return at once
+   * if a task is in queue
+   */
+  void Wait();
+
+  /**
+   * @brief Run tasks in queue until it's empty or Quit() is called
+   * @return The number of tasks run
+   */
+  size_t RunUntilQuit();
+
+  internal::MpscQueue queue_;
+
+  std::atomic<bool> sleeping_{false};
+
+  std::atomic<bool> quit_{false};
+
+  std::mutex mutex_;
+
+  std::condition_variable wake_;
+
+  bool signaled_ = false;  // guarded by mutex_
+
+};
+
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_EVENT_LOOP_HPP_
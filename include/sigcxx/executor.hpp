@@ -0,0 +1,202 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file executor.hpp
+ * @brief Header file for Executor, Task and TaskQueue.
+ */
+
+#ifndef WIZTK_BASE_EXECUTOR_HPP_
+#define WIZTK_BASE_EXECUTOR_HPP_
+
+#include "sigcxx/macros.hpp"
+
+#include <atomic>
+#include <cstddef>
+
+namespace sigcxx {
+
+namespace internal {
+class MpscQueue;
+}
+
+/**
+ * @ingroup base
+ * @brief A unit of work posted to an Executor
+ *
+ * A task is created by a queued connection for each emission, it owns a copy
+ * of the arguments. Call Run() exactly once, or Discard() if the task will
+ * never run, both free the task.
+ */
+class WIZTK_EXPORT Task {
+
+  friend class internal::MpscQueue;
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(Task);
+
+  /**
+   * @brief Run and free this task
+   */
+  void Run() {
+    function_(this, true);
+  }
+
+  /**
+   * @brief Free this task without running it
+   */
+  void Discard() {
+    function_(this, false);
+  }
+
+ protected:
+
+  /**
+   * @brief The function to run (if the bool argument is true) and free the task
+   */
+  typedef void (*Function)(Task *task, bool run);
+
+  explicit Task(Function function)
+      : function_(function) {}
+
+  ~Task() = default;
+
+ private:
+
+  std::atomic<Task *> next_{nullptr};  // used by the queue the task is in
+
+  Function function_;
+
+};
+
+/**
+ * @ingroup base
+ * @brief The interface of a thread which runs queued slot methods
+ *
+ * Signal::Connect() with an executor makes a queued connection: emitting the
+ * signal posts a Task to the executor instead of calling the slot method, the
+ * executor runs it later in its own thread.
+ *
+ * Implement Post() to hand the task to an event loop, or use TaskQueue.
+ */
+class WIZTK_EXPORT Executor {
+
+ public:
+
+  virtual ~Executor() = default;
+
+  /**
+   * @brief Queue a task, this may be called in any thread
+   */
+  virtual void Post(Task *task) = 0;
+
+};
+
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief An intrusive lock-free queue of tasks for many producers and one
+ * consumer
+ *
+ * Push() is one atomic exchange and never waits. Pop() may return nullptr
+ * while a push is half done, the task is seen by a later Pop().
+ */
+class WIZTK_EXPORT MpscQueue {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(MpscQueue);
+
+  MpscQueue();
+
+  ~MpscQueue() = default;
+
+  /**
+   * @brief Append a task, called in any thread
+   */
+  void Push(Task *task);
+
+  /**
+   * @brief Remove the first task, called in the consumer thread only
+   */
+  Task *Pop();
+
+  /**
+   * @brief Returns true if no task is in queue or being pushed, called in
+   * the consumer thread only
+   *
+   * This reads the head with a sequentially consistent load, a consumer
+   * which publishes that it's going to sleep before the call cannot miss a
+   * producer which checks for it after Push().
+   */
+  bool IsEmpty() const {
+    return (tail_ == &stub_) && (head_.load() == &stub_);
+  }
+
+ private:
+
+  std::atomic<Task *> head_;  // the last task pushed
+
+  Task *tail_;  // the next task to pop, owned by the consumer
+
+  Task stub_;
+
+};
+
+} // namespace internal
+
+/**
+ * @ingroup base
+ * @brief An Executor which keeps tasks until its thread runs them
+ *
+ * Any thread can post tasks, the thread owning the queue calls RunPending()
+ * to run them, e.g. once every frame in a rendering thread.
+ */
+class WIZTK_EXPORT TaskQueue : public Executor {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(TaskQueue);
+
+  TaskQueue() = default;
+
+  /**
+   * @brief Destructor, tasks not run are discarded
+   */
+  ~TaskQueue() override;
+
+  void Post(Task *task) override;
+
+  /**
+   * @brief Run the tasks in queue
+   * @return The number of tasks run
+   *
+   * Tasks posted by the tasks run here may be run in this call or the next.
+   */
+  size_t RunPending();
+
+ private:
+
+  internal::MpscQueue queue_;
+
+};
+
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_EXECUTOR_HPP_
@@ -0,0 +1,550 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file flat_signal.hpp
+ * @brief Header file for FlatSignal class.
+ */
+
+#ifndef WIZTK_BASE_FLAT_SIGNAL_HPP_
+#define WIZTK_BASE_FLAT_SIGNAL_HPP_
+
+#include "sigcxx/sigcxx.hpp"
+
+#include <vector>
+
+namespace sigcxx {
+
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief A TokenNode used in FlatSignal.
+ * @tparam ParamTypes
+ *
+ * The delegate of a FlatSignal connection is stored in the contiguous array of
+ * the signal, this token keeps the connection to a BindingNode and removes
+ * the delegate from the array when destroyed. A copy of the delegate is kept
+ * here only for Trackable::UnbindAllSignalsTo() and CountSignalBindings(),
+ * which do not walk the array.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT FlatToken : public SignalTokenNode {
+
+ public:
+
+  typedef FlatSignal<ParamTypes...> SignalType;
+  typedef Delegate<void(typename ArgRef<ParamTypes>::type..., SLOT)> DelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(FlatToken);
+  FlatToken() = delete;
+
+  FlatToken(SignalType *signal, const DelegateType &delegate)
+      : SignalTokenNode(kTokenFlat), signal_(signal), delegate_(delegate) {}
+
+  ~FlatToken() override {
+    signal_->Erase(this);
+  }
+
+  bool IsBoundTo(const void *object, GenericMethodPointer method) const final {
+    return delegate_.IsBoundTo(object, method);
+  }
+
+ private:
+
+  SignalType *signal_;
+
+  DelegateType delegate_;
+
+};
+
+} // namespace internal
+
+/**
+ * @ingroup base
+ * @brief A signal which keeps all delegates in one contiguous array
+ *
+ * FlatSignal has the same Connect/Disconnect/Emit interface and the same
+ * automatic disconnecting behaviour as Signal, but the delegates of all
+ * connections are stored in a single array and emitting iterates this array
+ * linearly instead of walking a linked list of heap-allocated tokens. Use it
+ * for signals with large fan-out, where emitting is dominated by memory latency.
+ *
+ * Disconnecting is O(n) as the array is compacted immediately. Connections
+ * removed or added by a slot method while emitting are handled the same way as
+ * in Signal.
+ *
+ * @note Slot::signal() returns nullptr in a slot method called by a FlatSignal.
+ */
+template<typename ... ParamTypes>
+class WIZTK_EXPORT FlatSignal : public Trackable {
+
+  friend class internal::FlatToken<ParamTypes...>;
+
+ public:
+
+  typedef typename internal::FlatToken<ParamTypes...>::DelegateType DelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(FlatSignal);
+
+  FlatSignal() = default;
+
+  ~FlatSignal() final;
+
+  /**
+   * @brief Connect this signal to a slot method in a observer
+   */
+  template<typename T>
+  Connection Connect(T *obj, void (T::*method)(ParamTypes..., SLOT), int index = -1) {
+    return Connect<T, ParamTypes..., SLOT>(obj, method, index);
+  }
+
+  /**
+   * @brief Connect this signal to a slot method with compatible parameter types
+   * @see Signal::Connect()
+   */
+  template<typename T, typename ... SlotParamTypes>
+  Connection Connect(T *obj, void (T::*method)(SlotParamTypes...), int index = -1);
+
+  Connection Connect(FlatSignal<ParamTypes...> &other, int index = -1);
+
+  /**
+   * @brief Disconnect all delegates to a method
+   */
+  template<typename T>
+  void DisconnectAll(T *obj, void (T::*method)(ParamTypes..., SLOT)) {
+    DisconnectAll<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  void DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...));
+
+  /**
+   * @brief Disconnect all signals
+   */
+  void DisconnectAll(FlatSignal<ParamTypes...> &other);
+
+  /**
+   * @brief Disconnect delegats to a method by given start position and counts
+   * @see Signal::Disconnect()
+   */
+  template<typename T>
+  int Disconnect(T *obj, void (T::*method)(ParamTypes..., SLOT), int start_pos = -1, int counts = 1) {
+    return Disconnect<T, ParamTypes..., SLOT>(obj, method, start_pos, counts);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  int Disconnect(T *obj, void (T::*method)(SlotParamTypes...), int start_pos = -1, int counts = 1);
+
+  /**
+   * @brief Disconnect connections to a signal by given start position and counts
+   * @see Signal::Disconnect()
+   */
+  int Disconnect(FlatSignal<ParamTypes...> &other, int start_pos = -1, int counts = 1);
+
+  /**
+   * @brief Disconnect any kind of connections from the start position
+   * @see Signal::Disconnect()
+   */
+  int Disconnect(int start_pos = -1, int counts = 1);
+
+  /**
+   * @brief Disconnect all
+   */
+  void DisconnectAll();
+
+  template<typename T>
+  bool IsConnectedTo(T *obj, void (T::*method)(ParamTypes..., SLOT)) const {
+    return IsConnectedTo<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  bool IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const;
+
+  bool IsConnectedTo(const FlatSignal<ParamTypes...> &other) const;
+
+  bool IsConnectedTo(const Trackable *obj) const;
+
+  template<typename T>
+  int CountConnections(T *obj, void (T::*method)(ParamTypes..., SLOT)) const {
+    return CountConnections<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  int CountConnections(T *obj, void (T::*method)(SlotParamTypes...)) const;
+
+  int CountConnections(const FlatSignal<ParamTypes...> &other) const;
+
+  int CountConnections() const {
+    return static_cast<int>(entries_.size());
+  }
+
+  bool empty() const {
+    return entries_.empty();
+  }
+
+  /**
+   * @brief Emit this signal
+   * @see Signal::Emit()
+   */
+  void Emit(ParamTypes ... Args) {
+    Dispatch(Args...);
+  }
+
+  void operator()(ParamTypes ... Args) {
+    Emit(std::forward<ParamTypes>(Args)...);
+  }
+
+  /**
+   * @brief Block or unblock this signal
+   * @see Signal::Block()
+   */
+  void Block(bool blocked = true) {
+    blocked_ = blocked;
+  }
+
+  void Unblock() {
+    Block(false);
+  }
+
+  bool IsBlocked() const {
+    return blocked_;
+  }
+
+ private:
+
+  typedef internal::FlatToken<ParamTypes...> TokenType;
+
+  /**
+   * @brief An element in the contiguous array
+   */
+  struct Entry {
+    DelegateType delegate;
+    TokenType *token;
+    bool blocked;  // a copy of token->blocked
+  };
+
+  /**
+   * @brief The status of an emission on stack
+   *
+   * Frames of nested emissions are linked so that the cursors can be adjusted
+   * when the array changes, and be notified if this signal is destroyed.
+   */
+  struct EmitFrame {
+
+    WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(EmitFrame);
+
+    explicit EmitFrame(FlatSignal *signal)
+        : signal(signal), outer(signal->frames_) {
+      signal->frames_ = this;
+    }
+
+    ~EmitFrame() {
+      if (!destroyed) signal->frames_ = outer;
+    }
+
+    FlatSignal *signal;
+    EmitFrame *outer;
+    size_t next = 0;  // the index of the entry to call after the current one
+    bool destroyed = false;
+  };
+
+  Connection Insert(const DelegateType &delegate, Trackable *trackable, int index);
+
+  void Erase(TokenType *token);
+
+  /**
+   * @brief Returns the index of the entry of the given token
+   */
+  size_t Find(const TokenType *token) const;
+
+  void OnTokenBlocked(internal::SignalTokenNode *token) final;
+
+  int Disconnect(const DelegateType &delegate, int start_pos, int counts);
+
+  void Dispatch(typename internal::ArgRef<ParamTypes>::type ... Args);
+
+  void Forward(typename internal::ArgRef<ParamTypes>::type ... Args, SLOT) {
+    Dispatch(Args...);
+  }
+
+  static DelegateType SignalDelegate(const FlatSignal &signal) {
+    return DelegateType::FromMethod(const_cast<FlatSignal *>(&signal), &FlatSignal::Forward);
+  }
+
+  std::vector<Entry> entries_;
+
+  EmitFrame *frames_ = nullptr;
+
+  bool blocked_ = false;
+
+};
+
+// FlatSignal implementation:
+
+template<typename ... ParamTypes>
+FlatSignal<ParamTypes...>::~FlatSignal() {
+  DisconnectAll();
+  for (EmitFrame *frame = frames_; frame; frame = frame->outer) {
+    frame->destroyed = true;
+  }
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+Connection FlatSignal<ParamTypes...>::Connect(T *obj, void (T::*method)(SlotParamTypes...), int index) {
+  static_assert(sizeof...(SlotParamTypes) == sizeof...(ParamTypes) + 1,
+                "The slot method must take the same number of parameters as the signal, plus a SLOT");
+
+  return Insert(DelegateType::FromMethod(obj, method), obj, index);
+}
+
+template<typename ... ParamTypes>
+Connection FlatSignal<ParamTypes...>::Connect(FlatSignal<ParamTypes...> &other, int index) {
+  return Insert(SignalDelegate(other), &other, index);
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+void FlatSignal<ParamTypes...>::DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...)) {
+  Disconnect(DelegateType::FromMethod(obj, method), -1, -1);
+}
+
+template<typename ... ParamTypes>
+void FlatSignal<ParamTypes...>::DisconnectAll(FlatSignal<ParamTypes...> &other) {
+  Disconnect(SignalDelegate(other), -1, -1);
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+int FlatSignal<ParamTypes...>::Disconnect(T *obj, void (T::*method)(SlotParamTypes...), int start_pos, int counts) {
+  return Disconnect(DelegateType::FromMethod(obj, method), start_pos, counts);
+}
+
+template<typename ... ParamTypes>
+int FlatSignal<ParamTypes...>::Disconnect(FlatSignal<ParamTypes...> &other, int start_pos, int counts) {
+  return Disconnect(SignalDelegate(other), start_pos, counts);
+}
+
+template<typename ... ParamTypes>
+int FlatSignal<ParamTypes...>::Disconnect(int start_pos, int counts) {
+  int ret_count = 0;
+
+  if (start_pos >= 0) {
+    size_t i = static_cast<size_t>(start_pos);
+    while (i < entries_.size()) {
+      ret_count++;
+      counts--;
+      delete entries_[i].token;  // erase this element
+
+      if (counts == 0) break;
+    }
+  } else {
+    size_t i = entries_.size();
+    while ((i > 0) && (start_pos < -1)) {
+      --i;
+      start_pos++;
+    }
+
+    while (i > 0) {
+      --i;
+      ret_count++;
+      counts--;
+      delete entries_[i].token;
+
+      if (counts == 0) break;
+    }
+  }
+
+  return ret_count;
+}
+
+template<typename ... ParamTypes>
+void FlatSignal<ParamTypes...>::DisconnectAll() {
+  // erase from the back so that no element is moved
+  while (!entries_.empty()) {
+    delete entries_.back().token;
+  }
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+bool FlatSignal<ParamTypes...>::IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const {
+  const DelegateType delegate = DelegateType::FromMethod(obj, method);
+  for (const Entry &entry : entries_) {
+    if (entry.delegate == delegate) return true;
+  }
+  return false;
+}
+
+template<typename ... ParamTypes>
+bool FlatSignal<ParamTypes...>::IsConnectedTo(const FlatSignal<ParamTypes...> &other) const {
+  const DelegateType delegate = SignalDelegate(other);
+  for (const Entry &entry : entries_) {
+    if (entry.delegate == delegate) return true;
+  }
+  return false;
+}
+
+template<typename ... ParamTypes>
+bool FlatSignal<ParamTypes...>::IsConnectedTo(const Trackable *obj) const {
+  for (const Entry &entry : entries_) {
+    if (entry.token->binding->trackable == obj) return true;
+  }
+  return false;
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+int FlatSignal<ParamTypes...>::CountConnections(T *obj, void (T::*method)(SlotParamTypes...)) const {
+  int count = 0;
+  const DelegateType delegate = DelegateType::FromMethod(obj, method);
+  for (const Entry &entry : entries_) {
+    if (entry.delegate == delegate) count++;
+  }
+  return count;
+}
+
+template<typename ... ParamTypes>
+int FlatSignal<ParamTypes...>::CountConnections(const FlatSignal<ParamTypes...> &other) const {
+  int count = 0;
+  const DelegateType delegate = SignalDelegate(other);
+  for (const Entry &entry : entries_) {
+    if (entry.delegate == delegate) count++;
+  }
+  return count;
+}
+
+template<typename ... ParamTypes>
+void FlatSignal<ParamTypes...>::Dispatch(typename internal::ArgRef<ParamTypes>::type ... Args) {
+  if (blocked_) return;
+
+  EmitFrame frame(this);
+  Slot slot(static_cast<internal::SignalTokenNode *>(nullptr));
+
+  // The array may be changed or reallocated in slot methods, always access
+  // elements by index and never keep a reference across a call
+  while (frame.next < entries_.size()) {
+    size_t pos = frame.next++;
+    if (entries_[pos].blocked) continue;
+
+    DelegateType delegate = entries_[pos].delegate;
+    slot.it_ = Slot::IteratorType(entries_[pos].token);
+    delegate.InvokeMethod(Args..., &slot);
+    if (frame.destroyed) return;
+  }
+}
+
+template<typename ... ParamTypes>
+Connection FlatSignal<ParamTypes...>::Insert(const DelegateType &delegate, Trackable *trackable, int index) {
+  // Same position rule as InterRelatedDeque::insert():
+  size_t pos = entries_.size();
+  if (index >= 0) {
+    if (static_cast<size_t>(index) < pos) pos = static_cast<size_t>(index);
+  } else {
+    while ((pos > 0) && (index < -1)) {
+      --pos;
+      index++;
+    }
+  }
+
+  auto *record = internal::ConnectionRecord<TokenType>::New(this, delegate);
+  auto *token = record->token();
+  auto *binding = record->binding();
+
+  Link(token, binding);
+  token->trackable = this;
+  PushBackBinding(trackable, binding);
+
+  entries_.insert(entries_.begin() + pos, Entry{delegate, token, false});
+
+  // Inserted before the next element, the emission in progress skips it:
+  for (EmitFrame *frame = frames_; frame; frame = frame->outer) {
+    if (pos < frame->next) ++frame->next;
+  }
+
+  return Connection(token);
+}
+
+template<typename ... ParamTypes>
+void FlatSignal<ParamTypes...>::Erase(TokenType *token) {
+  size_t pos = Find(token);
+  entries_.erase(entries_.begin() + pos);
+
+  // Removed before the next element, which moves to the previous index. As
+  // pos < next, next is at least 1 and never wraps around.
+  for (EmitFrame *frame = frames_; frame; frame = frame->outer) {
+    if (pos < frame->next) --frame->next;
+  }
+}
+
+template<typename ... ParamTypes>
+size_t FlatSignal<ParamTypes...>::Find(const TokenType *token) const {
+  // Connections are usually removed in reverse order, search from the back:
+  size_t pos = entries_.size();
+  while (pos > 0) {
+    --pos;
+    if (entries_[pos].token == token) break;
+  }
+  _ASSERT(entries_[pos].token == token);
+  return pos;
+}
+
+template<typename ... ParamTypes>
+void FlatSignal<ParamTypes...>::OnTokenBlocked(internal::SignalTokenNode *token) {
+  entries_[Find(static_cast<TokenType *>(token))].blocked = token->blocked;
+}
+
+template<typename ... ParamTypes>
+int FlatSignal<ParamTypes...>::Disconnect(const DelegateType &delegate, int start_pos, int counts) {
+  int ret_count = 0;
+
+  if (start_pos >= 0) {
+    size_t i = static_cast<size_t>(start_pos);
+    while (i < entries_.size()) {
+      if (entries_[i].delegate == delegate) {
+        ret_count++;
+        counts--;
+        delete entries_[i].token;  // the next element moves to i
+      } else {
+        ++i;
+      }
+      if (counts == 0) break;
+    }
+  } else {
+    size_t i = entries_.size();
+    while ((i > 0) && (start_pos < -1)) {
+      --i;
+      start_pos++;
+    }
+
+    while (i > 0) {
+      --i;
+      if (entries_[i].delegate == delegate) {
+        ret_count++;
+        counts--;
+        delete entries_[i].token;
+      }
+      if (counts == 0) break;
+    }
+  }
+
+  return ret_count;
+}
+
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_FLAT_SIGNAL_HPP_
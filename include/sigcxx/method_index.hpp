@@ -0,0 +1,116 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file method_index.hpp
+ * @brief Header file for the hash index of tokens by the method they call.
+ */
+
+#ifndef WIZTK_BASE_METHOD_INDEX_HPP_
+#define WIZTK_BASE_METHOD_INDEX_HPP_
+
+#include "sigcxx/delegate.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace sigcxx {
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief A node in MethodIndex
+ *
+ * Embed this in the element type and static_cast back in the index owner.
+ */
+struct WIZTK_EXPORT MethodIndexNode {
+  MethodIndexNode *next_in_bucket = nullptr;
+  MethodIndexNode **pprev_in_bucket = nullptr;  // the pointer to this node, for O(1) erase
+  size_t hash = 0;
+};
+
+/**
+ * @ingroup base_intern
+ * @brief An intrusive hash table of nodes by the object and method they call
+ *
+ * The index does not own the nodes and does not store the keys, only the
+ * hash values. The owner compares the nodes found with the same hash to the
+ * key it looks for, and must insert or erase a node in the index each time it
+ * does so in the list.
+ */
+class WIZTK_EXPORT MethodIndex {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(MethodIndex);
+
+  MethodIndex() = default;
+
+  ~MethodIndex() = default;
+
+  /**
+   * @brief Hash the object and member function pointer
+   *
+   * The method stub is left out, the same method connected through
+   * compatible parameter types has different stubs but is the same slot.
+   */
+  static size_t Hash(const void *object, GenericMethodPointer method);
+
+  void Insert(MethodIndexNode *node, size_t hash);
+
+  void Erase(MethodIndexNode *node);
+
+  /**
+   * @brief Get the first node with the hash value, or nullptr
+   */
+  MethodIndexNode *Find(size_t hash) const;
+
+  /**
+   * @brief Get the next node with the same hash value as the given one, or
+   * nullptr
+   */
+  static MethodIndexNode *FindNext(const MethodIndexNode *node);
+
+  /**
+   * @brief Forget all nodes and free the buckets
+   */
+  void Clear();
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return 0 == size_;
+  }
+
+ private:
+
+  void Rehash(size_t bucket_count);
+
+  static void Link(MethodIndexNode *node, MethodIndexNode **bucket);
+
+  std::vector<MethodIndexNode *> buckets_;
+
+  size_t size_ = 0;
+
+};
+
+} // namespace internal
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_METHOD_INDEX_HPP_
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file node_pool.hpp
+ * @brief Header file for the memory pool of connection nodes.
+ */
+
+#ifndef WIZTK_BASE_NODE_POOL_HPP_
+#define WIZTK_BASE_NODE_POOL_HPP_
+
+#include "sigcxx/macros.hpp"
+
+#include <cstddef>
+
+namespace sigcxx {
+
+/**
+ * @ingroup base
+ * @brief The functions used by the node pool to get memory
+ *
+ * By default they are the global operator new and delete.
+ *
+ * @see SetNodeAllocator()
+ */
+struct WIZTK_EXPORT NodeAllocator {
+  void *(*allocate)(size_t size);
+  void (*deallocate)(void *p, size_t size);
+};
+
+/**
+ * @ingroup base
+ * @brief Set the functions used to get memory for tokens and bindings
+ * @return false if the pool has been used, the allocator is then not changed
+ *
+ * The pool gets slabs of memory from the allocator, and nodes larger than
+ * the largest size class. Call this before any connection is made: memory
+ * from one allocator must not be freed to another.
+ */
+WIZTK_EXPORT bool SetNodeAllocator(const NodeAllocator &allocator);
+
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief A size-class pool for tokens and bindings
+ *
+ * Each thread keeps a small magazine of free blocks for every size class,
+ * allocating and freeing a node usually only touches the magazine. Magazines
+ * are refilled from and spilled to a global depot under a lock, the depot
+ * cuts new blocks from slabs. A slab is returned to the allocator once all
+ * its blocks are free, the depot keeps at most one unused slab for each
+ * size class.
+ */
+class WIZTK_EXPORT NodePool {
+
+ public:
+
+  /**
+   * @brief The size classes are multiples of kAlignment up to kMaxSize
+   */
+  static constexpr size_t kAlignment = 16;
+
+  static constexpr size_t kMaxSize = 256;
+
+  static constexpr size_t kClassCount = kMaxSize / kAlignment;
+
+  /**
+   * @brief The number of free blocks a thread keeps for each size class
+   */
+  static constexpr size_t kMagazineSize = 64;
+
+  /**
+   * @brief The size of a slab in bytes
+   */
+  static constexpr size_t kSlabSize = 16 * 1024;
+
+  NodePool() = delete;
+
+  static void *Allocate(size_t size);
+
+  static void Deallocate(void *p, size_t size);
+
+  /**
+   * @brief The bytes of the nodes allocated and not yet freed by the calling
+   * thread, in whole blocks
+   *
+   * A node freed in another thread is subtracted in that thread. This is for
+   * measuring the memory used by connections.
+   */
+  static ptrdiff_t CountThreadBytes();
+
+};
+
+} // namespace internal
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_NODE_POOL_HPP_
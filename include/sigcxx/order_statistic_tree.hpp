@@ -0,0 +1,132 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file order_statistic_tree.hpp
+ * @brief Header file for the order statistic tree used to index tokens.
+ */
+
+#ifndef WIZTK_BASE_ORDER_STATISTIC_TREE_HPP_
+#define WIZTK_BASE_ORDER_STATISTIC_TREE_HPP_
+
+#include "sigcxx/macros.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace sigcxx {
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief A node in OrderStatisticTree
+ *
+ * Embed this in the element type and static_cast back in the tree owner.
+ */
+struct WIZTK_EXPORT OrderStatisticNode {
+  OrderStatisticNode *parent = nullptr;
+  OrderStatisticNode *left = nullptr;
+  OrderStatisticNode *right = nullptr;
+  uint32_t size = 1;
+  uint32_t priority = 0;
+};
+
+/**
+ * @ingroup base_intern
+ * @brief A treap keyed by position, used as an index of a linked list
+ *
+ * The tree does not own the nodes, it only keeps the order of them so that
+ * the node at a position and the position of a node can be found in
+ * O(log n). The owner must insert or erase a node in the tree each time it
+ * does so in the list.
+ */
+class WIZTK_EXPORT OrderStatisticTree {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(OrderStatisticTree);
+
+  OrderStatisticTree() = default;
+
+  ~OrderStatisticTree() = default;
+
+  /**
+   * @brief Insert a node so that it will be at the given position
+   * @param node A node not in any tree
+   * @param position Must not be greater than size()
+   */
+  void Insert(OrderStatisticNode *node, size_t position);
+
+  /**
+   * @brief Remove a node from this tree
+   */
+  void Erase(OrderStatisticNode *node);
+
+  /**
+   * @brief Get the node at the given position, or nullptr
+   */
+  OrderStatisticNode *At(size_t position) const;
+
+  /**
+   * @brief Get the position of a node in this tree
+   */
+  static size_t PositionOf(const OrderStatisticNode *node);
+
+  /**
+   * @brief Forget all nodes
+   *
+   * The nodes are not reset, they must not be used in this tree again before
+   * inserted.
+   */
+  void Clear() {
+    root_ = nullptr;
+  }
+
+  size_t size() const {
+    return nullptr == root_ ? 0 : root_->size;
+  }
+
+  bool empty() const {
+    return nullptr == root_;
+  }
+
+ private:
+
+  static inline size_t SizeOf(const OrderStatisticNode *node) {
+    return nullptr == node ? 0 : node->size;
+  }
+
+  static void Update(OrderStatisticNode *node);
+
+  static void Split(OrderStatisticNode *tree,
+                    size_t count,
+                    OrderStatisticNode **left,
+                    OrderStatisticNode **right);
+
+  static OrderStatisticNode *Merge(OrderStatisticNode *left, OrderStatisticNode *right);
+
+  uint32_t NextPriority();
+
+  OrderStatisticNode *root_ = nullptr;
+
+  uint32_t seed_ = 2463534242;
+
+};
+
+} // namespace internal
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_ORDER_STATISTIC_TREE_HPP_
@@ -24,8 +24,20 @@
 
 #include "sigcxx/delegate.hpp"
 #include "sigcxx/binode.hpp"
+#include "sigcxx/executor.hpp"
+#include "sigcxx/method_index.hpp"
+#include "sigcxx/node_pool.hpp"
+#include "sigcxx/order_statistic_tree.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #ifndef __SLOT__
 /**
@@ -40,32 +52,98 @@ namespace sigcxx {
 // forward declaration
 class Trackable;
 class Slot;
+class Connection;
+class ThreadPool;  // include thread_pool.hpp to call EmitParallel()
+
+/**
+ * @ingroup base
+ * @brief A typedef of a pointer to a Slot.
+ */
+typedef Slot *SLOT;
 
 template<typename ... ParamTypes>
 class Signal;
 
+template<typename ... ParamTypes>
+class FlatSignal;
+
+template<typename ... ParamTypes>
+class ConcurrentSignal;
+
+template<typename Policy>
+class LockedTrackable;
+
+template<typename Policy, typename ... ParamTypes>
+class LockedSignal;
+
+class LockedConnection;
+
 namespace internal {
 
 // Foward declarations:
 struct SignalTokenNode;
+class Lockable;
+struct TrackableLocking;
 
+/**
+ * @ingroup base_intern
+ * @brief A unique address for each Signal type, used instead of dynamic_cast
+ */
 template<typename ... ParamTypes>
-class SignalToken;
+struct SignalTypeTag {
+  static const char id;
+};
+
+template<typename ... ParamTypes>
+const char SignalTypeTag<ParamTypes...>::id = 0;
 
 /**
  * @ingroup base_intern
- * @brief A bidirectional node used to save the status of a Slot object.
+ * @brief The type used to pass an argument from Signal::Emit() to slot methods.
+ * @tparam T A parameter type of the signal
+ *
+ * Emit() materializes each argument once and passes it to every token, slot
+ * method and chained signal by const reference, so that a slot method cannot
+ * change or move from the argument seen by the next ones. Scalar types
+ * (numbers, pointers, enums) are still passed by value as this is cheaper.
+ *
+ * Only a parameter declared as a non-const reference is passed as a mutable
+ * reference, all slot methods then share the object of the caller.
  */
-class WIZTK_NO_EXPORT SlotNode : public Binode<SlotNode> {
-  friend class Slot;
- public:
-  WIZTK_DECLARE_NONCOPYABLE(SlotNode);
-  SlotNode() = default;
-  ~SlotNode() override = default;
-  SlotNode(SlotNode &&) = default;
-  SlotNode &operator=(SlotNode &&) = default;
+template<typename T>
+struct ArgRef {
+  typedef typename std::conditional<std::is_scalar<T>::value, T, const T &>::type type;
+};
+
+template<typename T>
+struct ArgRef<T &> {
+  typedef T &type;
+};
+
+template<typename T>
+struct ArgRef<T &&> {
+  typedef T &type;
 };
 
+/**
+ * @ingroup base_intern
+ * @brief True if no parameter type is a reference to a non-const object
+ */
+template<typename ... ParamTypes>
+struct NoMutableRef;
+
+template<>
+struct NoMutableRef<> : std::true_type {};
+
+template<typename T, typename ... ParamTypes>
+struct NoMutableRef<T, ParamTypes...>
+    : std::integral_constant<bool, !(std::is_reference<T>::value &&
+        !std::is_const<typename std::remove_reference<T>::type>::value) &&
+        NoMutableRef<ParamTypes...>::value> {};
+
+template<typename ... ParamTypes>
+class SignalToken;
+
 /**
  * @ingroup base_intern
  * @brief Base class of a bidirectional node used in Trackable or Signal only.
@@ -74,6 +152,26 @@ class WIZTK_NO_EXPORT InterRelatedNodeBase : public Binode<InterRelatedNodeBase>
   friend class Trackable;
   template<typename ... ParamTypes> friend
   class Signal;
+  template<typename T> friend
+  class InterRelatedDeque;
+
+  /**
+   * @brief Cut all nodes between two end points, or all nodes of a ring
+   * through one end point, out in one go
+   * @return The first node, the nodes cut out are still linked to each other
+   * and end with nullptr on both sides
+   */
+  static InterRelatedNodeBase *CutBetween(InterRelatedNodeBase *head, InterRelatedNodeBase *tail) {
+    if (head->next_ == tail) return nullptr;
+
+    auto *first = static_cast<InterRelatedNodeBase *>(head->next_);
+    auto *last = static_cast<InterRelatedNodeBase *>(tail->previous_);
+    first->previous_ = nullptr;
+    last->next_ = nullptr;
+    head->next_ = tail;
+    tail->previous_ = head;
+    return first;
+  }
 };
 
 /**
@@ -92,111 +190,860 @@ class WIZTK_NO_EXPORT InterRelatedNodeEndpoint : public InterRelatedNodeBase {
  */
 struct WIZTK_NO_EXPORT TrackableBindingNode : public InterRelatedNodeBase {
   TrackableBindingNode() = default;
-  ~TrackableBindingNode() final;
+  ~TrackableBindingNode() override;
+
+  static void *operator new(size_t size) {
+    return NodePool::Allocate(size);
+  }
+
+  static void operator delete(void *p, size_t size) {
+    NodePool::Deallocate(p, size);
+  }
+
   Trackable *trackable = nullptr;
   SignalTokenNode *token = nullptr;
 };
 
+/**
+ * @ingroup base_intern
+ * @brief The kind of a SignalTokenNode, used instead of dynamic_cast
+ */
+enum TokenKind {
+  kTokenDelegate,  /**< DelegateToken */
+  kTokenSignal,  /**< SignalToken */
+  kTokenBatch,  /**< BatchToken */
+  kTokenQueued,  /**< QueuedToken */
+  kTokenCoalesced,  /**< CoalescedToken */
+  kTokenFlat,  /**< A token in FlatSignal */
+  kTokenConcurrent  /**< A token in ConcurrentSignal */
+};
+
+/**
+ * @ingroup base_intern
+ * @brief The fields of a token read in emission
+ *
+ * The delegate_storage is raw memory for the delegate of a CallableToken,
+ * all delegates have the same size. Being the second base of
+ * SignalTokenNode puts these right after the list links.
+ */
+struct WIZTK_NO_EXPORT TokenHead {
+  explicit TokenHead(TokenKind kind)
+      : kind(kind) {}
+  typename std::aligned_storage<sizeof(Delegate<void()>), alignof(Delegate<void()>)>::type delegate_storage;
+  const TokenKind kind;
+  bool blocked = false;  // skipped in emission, see Connection::Block()
+};
+
+/**
+ * @ingroup base_intern
+ * @brief The nodes of a token in the indexes of a signal with many
+ * connections
+ *
+ * Allocated for each token only when an index is built, so tokens of small
+ * signals do not carry the index nodes.
+ */
+struct WIZTK_NO_EXPORT TokenIndexEntry : public OrderStatisticNode,
+                                         public MethodIndexNode {
+  explicit TokenIndexEntry(SignalTokenNode *token)
+      : token(token) {}
+
+  static void *operator new(size_t size) {
+    return NodePool::Allocate(size);
+  }
+
+  static void operator delete(void *p, size_t size) {
+    NodePool::Deallocate(p, size);
+  }
+
+  SignalTokenNode *token;
+};
+
+/**
+ * @ingroup base_intern
+ * @brief The state of a Signal used only with many connections or chained
+ * signals
+ *
+ * Allocated on demand and kept behind one pointer in the signal, so a signal
+ * with a few connections pays 8 bytes for it.
+ */
+struct WIZTK_NO_EXPORT SignalSideTable {
+  /**
+   * @brief The order statistic index of the tokens, empty if not built
+   */
+  OrderStatisticTree positions;
+
+  /**
+   * @brief The hash index of the tokens by the object and method they call,
+   * empty if not built
+   */
+  MethodIndex methods;
+
+  /**
+   * @brief The tokens to slot methods of the signal and all chained signals
+   */
+  std::vector<SignalTokenNode *> dispatch;
+
+  /**
+   * @brief The number of emissions in progress through dispatch
+   */
+  size_t dispatching = 0;
+
+  /**
+   * @brief The tokens removed while dispatch is being iterated, skipped by
+   * the emissions in progress and cleared when they are all finished
+   */
+  std::unordered_set<const SignalTokenNode *> removed;
+
+  bool dispatch_valid = false;
+
+  bool IsIndexed() const {
+    return !positions.empty() || !methods.empty();
+  }
+
+  bool IsRemoved(const SignalTokenNode *token) const {
+    return !removed.empty() && (removed.count(token) > 0);
+  }
+};
+
 /**
  * @ingroup base_intern
  * @brief A bi-node stored in Signal with connection to a BindingNode.
  */
-struct WIZTK_NO_EXPORT SignalTokenNode : public InterRelatedNodeBase {
+struct WIZTK_NO_EXPORT SignalTokenNode : public InterRelatedNodeBase,
+                                         public TokenHead {
   friend class Slot;
-  SignalTokenNode() = default;
+  SignalTokenNode() = delete;
+  explicit SignalTokenNode(TokenKind kind)
+      : TokenHead(kind) {}
   ~SignalTokenNode() override;
+
+  static void *operator new(size_t size) {
+    return NodePool::Allocate(size);
+  }
+
+  static void operator delete(void *p, size_t size) {
+    NodePool::Deallocate(p, size);
+  }
+
+  /**
+   * @brief Returns if this token calls the given method of the object
+   *
+   * The parameter types of the method are not compared, this is used by a
+   * Trackable which does not know the parameter types of the signal.
+   */
+  virtual bool IsBoundTo(const void * /* object */, GenericMethodPointer /* method */) const {
+    return false;
+  }
+
+  /**
+   * @brief Returns the hash of the object and method this token calls
+   * @see MethodIndex::Hash()
+   */
+  virtual size_t HashMethod() const {
+    return MethodIndex::Hash(nullptr, nullptr);
+  }
+
+  /**
+   * @brief Block or unblock this token and tell the signal
+   */
+  void SetBlocked(bool blocked);
+
+  /**
+   * @brief Returns if this is a BatchToken
+   */
+  bool IsBatch() const {
+    return kTokenBatch == kind;
+  }
+
+  /**
+   * @brief Returns if this is a SignalToken forwarding to another signal
+   */
+  bool IsForwarding() const {
+    return kTokenSignal == kind;
+  }
+
   Trackable *trackable = nullptr;
   TrackableBindingNode *binding = nullptr;
-  SlotNode slot_mark_head;
+  Connection *connection = nullptr;  // the handle returned by Connect(), if any
+  TokenIndexEntry *index_entry = nullptr;  // set only in an indexed signal
+};
+
+/**
+ * @ingroup base_intern
+ * @brief A TokenNode with a delegate to be invoked.
+ * @tparam ParamTypes
+ *
+ * The method stub in the delegate works as the invocation thunk, invoking a
+ * token is a single indirect call. DelegateToken and SignalToken only differ
+ * in the object and method the delegate is bound to.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT CallableToken : public SignalTokenNode {
+
+ public:
+
+  typedef Delegate<void(typename ArgRef<ParamTypes>::type...)> DelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(CallableToken);
+
+  CallableToken() = delete;
+
+  CallableToken(TokenKind kind, const DelegateType &d)
+      : SignalTokenNode(kind) {
+    static_assert(sizeof(DelegateType) == sizeof(delegate_storage) &&
+        alignof(DelegateType) == alignof(decltype(delegate_storage)), "Delegate does not fit");
+    new(&delegate_storage) DelegateType(d);
+  }
+
+  ~CallableToken() override {
+    delegate().~DelegateType();
+  }
+
+  inline void Invoke(typename ArgRef<ParamTypes>::type ... Args) const {
+    delegate().InvokeMethod(Args...);
+  }
+
+  inline const DelegateType &delegate() const {
+    return *reinterpret_cast<const DelegateType *>(&delegate_storage);
+  }
+
+  bool IsBoundTo(const void *object, GenericMethodPointer method) const override {
+    return delegate().IsBoundTo(object, method);
+  }
+
+  size_t HashMethod() const override {
+    return MethodIndex::Hash(delegate().object(), delegate().method());
+  }
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief A TokenNode with a delegate to a slot method.
+ * @tparam ParamTypes
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT DelegateToken : public CallableToken<ParamTypes...> {
+
+ public:
+
+  typedef typename CallableToken<ParamTypes...>::DelegateType DelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(DelegateToken);
+  DelegateToken() = delete;
+
+  explicit DelegateToken(const DelegateType &d)
+      : CallableToken<ParamTypes...>(kTokenDelegate, d) {}
+
+  ~DelegateToken() override = default;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief A TokenNode points to a Signal.
+ * @tparam ParamTypes
+ *
+ * The delegate is bound to Signal::Forward() of the signal connected.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT SignalToken : public CallableToken<ParamTypes..., SLOT> {
+
+ public:
+
+  typedef Signal<ParamTypes...> SignalType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(SignalToken);
+  SignalToken() = delete;
+
+  typedef typename CallableToken<ParamTypes..., SLOT>::DelegateType DelegateType;
+
+  explicit SignalToken(SignalType &signal)
+      : CallableToken<ParamTypes..., SLOT>(kTokenSignal, DelegateType::FromMethod(&signal, &SignalType::Forward)),
+        signal_(&signal) {}
+
+  ~SignalToken() override = default;
+
+  SignalType *signal() const {
+    return signal_;
+  }
+
+ private:
+
+  SignalType *signal_;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief Cast a token to SignalToken by its kind, or returns nullptr
+ */
+template<typename ... ParamTypes>
+inline SignalToken<ParamTypes...> *SignalTokenCast(SignalTokenNode *token) {
+  return token->IsForwarding() ? static_cast<SignalToken<ParamTypes...> *>(token) : nullptr;
+}
+
+/**
+ * @ingroup base_intern
+ * @brief A TokenNode with a delegate to a batch slot method.
+ * @tparam ParamTypes
+ *
+ * Signal::EmitBatch() calls the batch slot method once with all argument
+ * tuples. Signal::Emit() calls it with a batch of one tuple, which is copied
+ * from the arguments.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT BatchToken : public CallableToken<ParamTypes..., SLOT> {
+
+ public:
+
+  typedef std::tuple<ParamTypes...> TupleType;
+  typedef Delegate<void(TupleType *, size_t, SLOT)> BatchDelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(BatchToken);
+  BatchToken() = delete;
+
+  typedef typename CallableToken<ParamTypes..., SLOT>::DelegateType DelegateType;
+
+  explicit BatchToken(const BatchDelegateType &d)
+      : CallableToken<ParamTypes..., SLOT>(kTokenBatch, DelegateType::FromMethod(this, &BatchToken::InvokeOne)),
+        batch_delegate_(d) {}
+
+  ~BatchToken() override = default;
+
+  inline void InvokeBatch(TupleType *tuples, size_t count, SLOT slot) const {
+    batch_delegate_.InvokeMethod(tuples, count, slot);
+  }
+
+  bool IsBoundTo(const void *object, GenericMethodPointer method) const final {
+    return batch_delegate_.IsBoundTo(object, method);
+  }
+
+  size_t HashMethod() const final {
+    return MethodIndex::Hash(batch_delegate_.object(), batch_delegate_.method());
+  }
+
+ private:
+
+  void InvokeOne(typename ArgRef<ParamTypes>::type ... Args, SLOT slot) {
+    TupleType tuple(Args...);
+    batch_delegate_.InvokeMethod(&tuple, 1, slot);
+  }
+
+  BatchDelegateType batch_delegate_;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief The slot method of a queued connection
+ * @tparam ParamTypes
+ *
+ * Shared by the QueuedToken and the calls posted but not run yet. The token
+ * clears connected when the connection is removed, e.g. when the observer
+ * is destroyed, so the calls still in queue are skipped.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT QueuedTarget {
+
+ public:
+
+  typedef Delegate<void(typename ArgRef<ParamTypes>::type..., SLOT)> DelegateType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(QueuedTarget);
+  QueuedTarget() = delete;
+
+  static QueuedTarget *New(const DelegateType &delegate, Executor *executor) {
+    return new(NodePool::Allocate(sizeof(QueuedTarget))) QueuedTarget(delegate, executor);
+  }
+
+  void Reference() {
+    refs_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void Release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->~QueuedTarget();
+      NodePool::Deallocate(this, sizeof(QueuedTarget));
+    }
+  }
+
+  const DelegateType &delegate() const {
+    return delegate_;
+  }
+
+  Executor *executor() const {
+    return executor_;
+  }
+
+  std::atomic<bool> connected{true};
+
+ private:
+
+  QueuedTarget(const DelegateType &delegate, Executor *executor)
+      : delegate_(delegate), executor_(executor) {}
+
+  ~QueuedTarget() = default;
+
+  std::atomic<int> refs_{1};
+
+  DelegateType delegate_;
+
+  Executor *executor_;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief A Task which calls the slot method of a queued connection with a
+ * copy of the arguments
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT QueuedCall final : public Task {
+
+ public:
+
+  typedef QueuedTarget<ParamTypes...> TargetType;
+  typedef std::tuple<typename std::decay<ParamTypes>::type...> TupleType;
+
+  static QueuedCall *New(TargetType *target, typename ArgRef<ParamTypes>::type ... Args) {
+    return new(NodePool::Allocate(sizeof(QueuedCall))) QueuedCall(target, Args...);
+  }
+
+ private:
+
+  QueuedCall(TargetType *target, typename ArgRef<ParamTypes>::type ... Args)
+      : Task(&QueuedCall::Execute), target_(target), args_(Args...) {
+    target_->Reference();
+  }
+
+  ~QueuedCall() {
+    target_->Release();
+  }
+
+  static void Execute(Task *task, bool run) {
+    auto *call = static_cast<QueuedCall *>(task);
+    if (run && call->target_->connected.load(std::memory_order_acquire)) {
+      call->Invoke(std::index_sequence_for<ParamTypes...>());
+    }
+    call->~QueuedCall();
+    NodePool::Deallocate(call, sizeof(QueuedCall));
+  }
+
+  template<size_t ... I>
+  void Invoke(std::index_sequence<I...>) {
+    target_->delegate().InvokeMethod(std::get<I>(args_)..., nullptr);
+  }
+
+  TargetType *target_;
+
+  TupleType args_;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief A TokenNode which posts a QueuedCall to an executor.
+ * @tparam ParamTypes
+ *
+ * Like BatchToken, the delegate of the token is bound to the token itself,
+ * the slot method is in the QueuedTarget.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT QueuedToken : public CallableToken<ParamTypes..., SLOT> {
+
+ public:
+
+  typedef QueuedTarget<ParamTypes...> TargetType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(QueuedToken);
+  QueuedToken() = delete;
+
+  typedef typename CallableToken<ParamTypes..., SLOT>::DelegateType DelegateType;
+
+  explicit QueuedToken(TargetType *target)
+      : CallableToken<ParamTypes..., SLOT>(kTokenQueued, DelegateType::FromMethod(this, &QueuedToken::Post)),
+        target_(target) {}
+
+  ~QueuedToken() override {
+    target_->connected.store(false, std::memory_order_release);
+    target_->Release();
+  }
+
+  bool IsBoundTo(const void *object, GenericMethodPointer method) const final {
+    return target_->delegate().IsBoundTo(object, method);
+  }
+
+  size_t HashMethod() const final {
+    return MethodIndex::Hash(target_->delegate().object(), target_->delegate().method());
+  }
+
+ private:
+
+  void Post(typename ArgRef<ParamTypes>::type ... Args, SLOT /* slot */) {
+    target_->executor()->Post(QueuedCall<ParamTypes...>::New(target_, Args...));
+  }
+
+  TargetType *target_;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief Yield the thread until the spin lock is taken
+ */
+WIZTK_EXPORT void WaitSpinLock(std::atomic_flag *flag);
+
+/**
+ * @ingroup base_intern
+ * @brief The slot method and the pending arguments of a coalescing queued
+ * connection
+ * @tparam ParamTypes
+ *
+ * The target is also the only Task of the connection: it's posted when the
+ * first emission is pending, and later emissions merge their arguments into
+ * the pending ones until the executor runs it. The task takes the arguments
+ * out before calling the slot method, an emission after that posts it again.
+ *
+ * The arguments are guarded by a spin lock held only to copy or merge them,
+ * a thread waiting for it yields.
+ */
+template<typename ... ParamTypes>
+class WIZTK_NO_EXPORT CoalescedTarget final : public Task {
+
+ public:
+
+  typedef Delegate<void(typename ArgRef<ParamTypes>::type..., SLOT)> DelegateType;
+  typedef std::tuple<typename std::decay<ParamTypes>::type...> TupleType;
+  typedef void (*MergeFunction)(TupleType *pending, typename ArgRef<ParamTypes>::type ... Args);
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(CoalescedTarget);
+  CoalescedTarget() = delete;
+
+  static CoalescedTarget *New(const DelegateType &delegate, Executor *executor, MergeFunction merge) {
+    return new(NodePool::Allocate(sizeof(CoalescedTarget))) CoalescedTarget(delegate, executor, merge);
+  }
+
+  void Release() {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      this->~CoalescedTarget();
+      NodePool::Deallocate(this, sizeof(CoalescedTarget));
+    }
+  }
+
+  /**
+   * @brief Merge the arguments into the pending ones, or post this task
+   */
+  void Post(typename ArgRef<ParamTypes>::type ... Args) {
+    Lock();
+    if (pending_) {
+      if (nullptr != merge_) {
+        merge_(Pending(), Args...);
+      } else {
+        *Pending() = TupleType(Args...);
+      }
+      Unlock();
+      return;
+    }
+
+    new(&args_) TupleType(Args...);
+    pending_ = true;
+    refs_.fetch_add(1, std::memory_order_relaxed);  // released when run or discarded
+    Unlock();
+
+    executor_->Post(this);
+  }
+
+  const DelegateType &delegate() const {
+    return delegate_;
+  }
+
+  std::atomic<bool> connected{true};
+
+ private:
+
+  CoalescedTarget(const DelegateType &delegate, Executor *executor, MergeFunction merge)
+      : Task(&CoalescedTarget::Execute), delegate_(delegate), executor_(executor), merge_(merge) {}
+
+  ~CoalescedTarget() = default;
+
+  static void Execute(Task *task, bool run) {
+    auto *target = static_cast<CoalescedTarget *>(task);
+    typename std::aligned_storage<sizeof(TupleType), alignof(TupleType)>::type storage;
+
+    target->Lock();
+    auto *args = new(&storage) TupleType(std::move(*target->Pending()));
+    target->Pending()->~TupleType();
+    target->pending_ = false;
+    target->Unlock();
+
+    if (run && target->connected.load(std::memory_order_acquire)) {
+      target->Invoke(args, std::index_sequence_for<ParamTypes...>());
+    }
+    args->~TupleType();
+    target->Release();
+  }
+
+  template<size_t ... I>
+  void Invoke(TupleType *args, std::index_sequence<I...>) {
+    delegate_.InvokeMethod(std::get<I>(*args)..., nullptr);
+  }
+
+  TupleType *Pending() {
+    return reinterpret_cast<TupleType *>(&args_);
+  }
+
+  void Lock() {
+    if (lock_.test_and_set(std::memory_order_acquire)) WaitSpinLock(&lock_);
+  }
+
+  void Unlock() {
+    lock_.clear(std::memory_order_release);
+  }
+
+  std::atomic<int> refs_{1};
+
+  std::atomic_flag lock_ = ATOMIC_FLAG_INIT;
+
+  bool pending_ = false;  // guarded by lock_
+
+  typename std::aligned_storage<sizeof(TupleType), alignof(TupleType)>::type args_;  // valid if pending_
+
+  DelegateType delegate_;
+
+  Executor *executor_;
+
+  MergeFunction merge_;
+
 };
 
 /**
  * @ingroup base_intern
- * @brief A TokenNode with a virtual method to be invoked.
+ * @brief A TokenNode which posts the CoalescedTarget of a connection
  * @tparam ParamTypes
+ *
+ * The same as QueuedToken but for a CoalescedTarget.
  */
 template<typename ... ParamTypes>
-class WIZTK_NO_EXPORT CallableToken : public SignalTokenNode {
+class WIZTK_NO_EXPORT CoalescedToken : public CallableToken<ParamTypes..., SLOT> {
 
  public:
 
-  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(CallableToken);
+  typedef CoalescedTarget<ParamTypes...> TargetType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(CoalescedToken);
+  CoalescedToken() = delete;
+
+  typedef typename CallableToken<ParamTypes..., SLOT>::DelegateType DelegateType;
+
+  explicit CoalescedToken(TargetType *target)
+      : CallableToken<ParamTypes..., SLOT>(kTokenCoalesced, DelegateType::FromMethod(this, &CoalescedToken::Post)),
+        target_(target) {}
+
+  ~CoalescedToken() override {
+    target_->connected.store(false, std::memory_order_release);
+    target_->Release();
+  }
+
+  bool IsBoundTo(const void *object, GenericMethodPointer method) const final {
+    return target_->delegate().IsBoundTo(object, method);
+  }
 
-  CallableToken() = default;
+  size_t HashMethod() const final {
+    return MethodIndex::Hash(target_->delegate().object(), target_->delegate().method());
+  }
 
-  ~CallableToken() override = default;
+ private:
 
-  virtual void Invoke(ParamTypes ... Args) {
-    // Override this in sub class
+  void Post(typename ArgRef<ParamTypes>::type ... Args, SLOT /* slot */) {
+    target_->Post(Args...);
   }
 
+  TargetType *target_;
+
 };
 
 /**
  * @ingroup base_intern
- * @brief A TokenNode with a delegate.
- * @tparam ParamTypes
+ * @brief A token or binding node constructed in a ConnectionCell.
+ * @tparam NodeType DelegateToken, SignalToken or TrackableBindingNode
+ *
+ * The node is destroyed with 'delete' as any other node, the class-specific
+ * operator delete does not free memory but the destructor marks the place in
+ * the cell as free to be reused.
  */
-template<typename ... ParamTypes>
-class WIZTK_NO_EXPORT DelegateToken : public CallableToken<ParamTypes...> {
+template<typename NodeType>
+class WIZTK_NO_EXPORT InlineNode final : public NodeType {
 
  public:
 
-  typedef Delegate<void(ParamTypes...)> DelegateType;
-
-  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(DelegateToken);
-  DelegateToken() = delete;
-
-  explicit DelegateToken(const DelegateType &d)
-      : CallableToken<ParamTypes...>(), delegate_(d) {}
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(InlineNode);
+  InlineNode() = delete;
 
-  ~DelegateToken() final = default;
+  template<typename ... ArgTypes>
+  explicit InlineNode(bool *in_use, ArgTypes &&... Args)
+      : NodeType(std::forward<ArgTypes>(Args)...), in_use_(in_use) {
+    *in_use_ = true;
+  }
 
-  virtual void Invoke(ParamTypes... Args) final {
-    delegate_(Args...);
+  ~InlineNode() final {
+    *in_use_ = false;
   }
 
-  inline const DelegateType &delegate() const {
-    return delegate_;
+  static void *operator new(size_t /* size */, void *place) {
+    return place;
   }
 
+  static void operator delete(void * /* place */, void * /* place */) {}
+
+  static void operator delete(void * /* p */) {}
+
  private:
 
-  DelegateType delegate_;
+  bool *in_use_;
 
 };
 
 /**
  * @ingroup base_intern
- * @brief A TokenNode points to a Signal.
+ * @brief Memory for the token and binding of one connection.
  * @tparam ParamTypes
+ *
+ * A Signal can be given an array of cells owned by a subclass (e.g.
+ * StaticSignal), connections are created in free cells without allocation.
+ *
+ * A cell is sized for the common connections, to a slot method or a
+ * chained signal. Batch, queued and coalesced connections carry more state
+ * and are always allocated.
  */
 template<typename ... ParamTypes>
-class WIZTK_NO_EXPORT SignalToken : public CallableToken<ParamTypes...> {
+struct WIZTK_NO_EXPORT ConnectionCell {
+
+  typedef InlineNode<DelegateToken<ParamTypes..., SLOT>> DelegateTokenType;
+  typedef InlineNode<SignalToken<ParamTypes...>> SignalTokenType;
+  typedef InlineNode<TrackableBindingNode> BindingType;
+
+  typedef typename std::aligned_union<0, DelegateTokenType, SignalTokenType>::type TokenStorage;
+
+  /**
+   * @brief If a token of the given type can be created in a cell
+   */
+  template<typename TokenType>
+  struct Fits : std::integral_constant<bool,
+                                       sizeof(InlineNode<TokenType>) <= sizeof(TokenStorage) &&
+                                           alignof(InlineNode<TokenType>) <= alignof(TokenStorage)> {
+  };
+
+  bool IsFree() const {
+    return !token_in_use && !binding_in_use;
+  }
+
+  TokenStorage token;
+  typename std::aligned_storage<sizeof(BindingType), alignof(BindingType)>::type binding;
+  bool token_in_use = false;
+  bool binding_in_use = false;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief The token and binding of one connection in a single allocation.
+ * @tparam TokenType DelegateToken, SignalToken, BatchToken or FlatToken
+ *
+ * The token is placed first and the binding, which is not touched in
+ * emission, after it. The two nodes are still destroyed one by one with
+ * 'delete', the record is freed by the one deleted last.
+ */
+template<typename TokenType>
+class WIZTK_NO_EXPORT ConnectionRecord {
 
  public:
 
-  typedef Signal<ParamTypes...> SignalType;
+  class Token final : public TokenType {
 
-  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(SignalToken);
-  SignalToken() = delete;
+   public:
 
-  explicit SignalToken(SignalType &signal)
-      : CallableToken<ParamTypes...>(), signal_(&signal) {}
+    WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(Token);
+    Token() = delete;
+
+    template<typename ... ArgTypes>
+    explicit Token(ArgTypes &&... Args)
+        : TokenType(std::forward<ArgTypes>(Args)...) {}
+
+    ~Token() final = default;
+
+    static void *operator new(size_t /* size */, void *place) {
+      return place;
+    }
+
+    static void operator delete(void * /* place */, void * /* place */) {}
+
+    static void operator delete(void *p) {
+      Release(reinterpret_cast<ConnectionRecord *>(p));
+    }
+
+  };
+
+  class Binding final : public TrackableBindingNode {
+
+   public:
+
+    WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(Binding);
+
+    Binding() = default;
+
+    ~Binding() final = default;
+
+    static void *operator new(size_t /* size */, void *place) {
+      return place;
+    }
+
+    static void operator delete(void * /* place */, void * /* place */) {}
+
+    static void operator delete(void *p) {
+      Release(reinterpret_cast<ConnectionRecord *>(static_cast<char *>(p) - offsetof(ConnectionRecord, binding_)));
+    }
+
+  };
 
-  ~SignalToken() final = default;
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(ConnectionRecord);
 
-  virtual void Invoke(ParamTypes... Args) final {
-    signal_->Emit(Args...);
+  /**
+   * @brief Allocate a record from NodePool and construct the token and
+   * binding in it
+   */
+  template<typename ... ArgTypes>
+  static ConnectionRecord *New(ArgTypes &&... Args) {
+    auto *record = new(NodePool::Allocate(sizeof(ConnectionRecord))) ConnectionRecord;
+    new(&record->token_) Token(std::forward<ArgTypes>(Args)...);
+    new(&record->binding_) Binding;
+    return record;
   }
 
-  const SignalType *signal() const {
-    return signal_;
+  Token *token() {
+    return reinterpret_cast<Token *>(&token_);
+  }
+
+  Binding *binding() {
+    return reinterpret_cast<Binding *>(&binding_);
   }
 
  private:
 
-  SignalType *signal_;
+  ConnectionRecord() = default;
+
+  ~ConnectionRecord() = default;
+
+  static void Release(ConnectionRecord *record) {
+    if (0 == --record->alive_) {
+      record->~ConnectionRecord();
+      NodePool::Deallocate(record, sizeof(ConnectionRecord));
+    }
+  }
+
+  typename std::aligned_storage<sizeof(Token), alignof(Token)>::type token_;
+  typename std::aligned_storage<sizeof(Binding), alignof(Binding)>::type binding_;
+  int alive_ = 2;  // the token and the binding
 
 };
 
@@ -204,6 +1051,9 @@ class WIZTK_NO_EXPORT SignalToken : public CallableToken<ParamTypes...> {
  * @ingroup base_intern
  * @brief A simple double-ended queue to store bindings or tokens.
  * @tparam T Must be BindingNode or TokenNode
+ *
+ * The nodes are linked in a ring through one end point, which is both end()
+ * and rend().
  */
 template<typename T>
 class WIZTK_NO_EXPORT InterRelatedDeque {
@@ -248,12 +1098,6 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
 
     T *operator->() const { return get(); }
 
-    explicit operator bool() const {
-      return nullptr == current_ ?
-             false : (nullptr == current_->previous() ?
-                      false : (nullptr != current_->next()));
-    }
-
    private:
 
     internal::InterRelatedNodeBase *current_ = nullptr;
@@ -293,12 +1137,6 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
 
     const T *operator->() const { return get(); }
 
-    explicit operator bool() const {
-      return nullptr == current_ ?
-             false : (nullptr == current_->previous() ?
-                      false : (nullptr != current_->next()));
-    }
-
    private:
 
     const internal::InterRelatedNodeBase *current_ = nullptr;
@@ -338,12 +1176,6 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
 
     T *operator->() const { return get(); }
 
-    explicit operator bool() const {
-      return nullptr == current_ ?
-             false : (nullptr == current_->previous() ?
-                      false : (nullptr != current_->next()));
-    }
-
    private:
 
     internal::InterRelatedNodeBase *current_ = nullptr;
@@ -383,12 +1215,6 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
 
     const T *operator->() const { return get(); }
 
-    explicit operator bool() const {
-      return nullptr == current_ ?
-             false : (nullptr == current_->previous() ?
-                      false : (nullptr != current_->next()));
-    }
-
    private:
 
     const internal::InterRelatedNodeBase *current_ = nullptr;
@@ -398,7 +1224,10 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
   /**
    * @brief Default constructor.
    */
-  InterRelatedDeque() { head_.push_back(&tail_); }
+  InterRelatedDeque() {
+    end_.previous_ = &end_;
+    end_.next_ = &end_;
+  }
 
   /**
    * @brief Destructor.
@@ -412,7 +1241,8 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
   void push_back(T *node) {
     // link binding and token before calling this method:
     _ASSERT(nullptr != node->trackable);
-    tail_.push_front(node);
+    end_.push_front(node);
+    size_++;
   }
 
   /**
@@ -422,7 +1252,8 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
   void push_front(T *node) {
     // link binding and token before calling this method:
     _ASSERT(nullptr != node->trackable);
-    head_.push_back(node);
+    end_.push_back(node);
+    size_++;
   }
 
   /**
@@ -448,26 +1279,78 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
       }
       it->push_back(node);
     }
+    size_++;
+  }
+
+  /**
+   * @brief Insert element before the given one in this deque.
+   * @param node
+   * @param position
+   */
+  void insert_before(T *node, T *position) {
+    _ASSERT(nullptr != node->trackable);
+    position->push_front(node);
+    size_++;
+  }
+
+  /**
+   * @brief Remove an element, this is called when the element is being
+   * destroyed.
+   * @param node
+   */
+  void erase(T *node) {
+    _ASSERT(node->is_linked() && size_ > 0);
+    node->unlink();
+    size_--;
   }
 
+  /**
+   * @brief Remove all elements without unlinking them one by one.
+   * @return The first element or nullptr, walk the removed elements with
+   * next() until nullptr
+   */
+  T *detach_all() {
+    size_ = 0;
+    return static_cast<T *>(internal::InterRelatedNodeBase::CutBetween(&end_, &end_));
+  }
+
+  /**
+   * @brief Returns the number of elements.
+   * @return
+   */
+  size_t size() const { return size_; }
+
+  /**
+   * @brief Returns if there's no element.
+   * @return
+   */
+  bool empty() const { return 0 == size_; }
+
+  /**
+   * @brief Returns if the node is the end point, which is end() and rend().
+   * @param node
+   * @return
+   */
+  bool is_end(const internal::InterRelatedNodeBase *node) const { return node == &end_; }
+
   /**
    * @brief Return iterator to beginning.
    * @return
    */
-  Iterator begin() const { return Iterator(head_.next()); }
+  Iterator begin() const { return Iterator(end_.next()); }
 
   /**
    * @brief Return const iterator to beginning.
    * @return
    */
-  ConstIterator cbegin() const { return ConstIterator(head_.next()); }
+  ConstIterator cbegin() const { return ConstIterator(end_.next()); }
 
   /**
    * @brief Return iterator to end.
    * @return
    */
   Iterator end() const {
-    const internal::InterRelatedNodeBase *p = &tail_;
+    const internal::InterRelatedNodeBase *p = &end_;
     return Iterator(const_cast<internal::InterRelatedNodeBase *>(p));
   }
 
@@ -475,26 +1358,26 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
    * @brief Return const iterator to end.
    * @return
    */
-  ConstIterator cend() const { return ConstIterator(&tail_); }
+  ConstIterator cend() const { return ConstIterator(&end_); }
 
   /**
    * @brief Return reverse iterator to reverse beginning
    * @return
    */
-  ReverseIterator rbegin() const { return ReverseIterator(tail_.previous()); }
+  ReverseIterator rbegin() const { return ReverseIterator(end_.previous()); }
 
   /**
    * @brief Return const reverse iterator to reverse beginning.
    * @return
    */
-  ConstReverseIterator crbegin() const { return ConstReverseIterator(tail_.previous()); }
+  ConstReverseIterator crbegin() const { return ConstReverseIterator(end_.previous()); }
 
   /**
    * @brief Return reverse iterator to reverse end.
    * @return
    */
   ReverseIterator rend() const {
-    const internal::InterRelatedNodeBase *p = &head_;
+    const internal::InterRelatedNodeBase *p = &end_;
     return ReverseIterator(const_cast<internal::InterRelatedNodeBase *>(p));
   }
 
@@ -502,14 +1385,15 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
    * @brief Return const reverse iterator to reverse end.
    * @return
    */
-  ConstReverseIterator crend() const { return ConstReverseIterator(&head_); }
+  ConstReverseIterator crend() const { return ConstReverseIterator(&end_); }
 
  private:
 
   typedef InterRelatedNodeEndpoint EndpointType;
 
-  EndpointType head_;
-  EndpointType tail_;
+  EndpointType end_;
+
+  size_t size_ = 0;
 
 };
 
@@ -528,107 +1412,301 @@ class WIZTK_NO_EXPORT InterRelatedDeque {
  * A Signal holds a list of token to support multicast, when it's being
  * emitted, it create a simple Slot object and use it as an iterater and call
  * each delegate (@ref Delegate) to the slot method or another signal.
+ *
+ * The Slot objects of nested emissions are linked in the signal. Nothing is
+ * written to the tokens while emitting, if the token a Slot points to is
+ * removed in a slot method, the signal moves the Slot to the next token
+ * instead.
  */
 class WIZTK_EXPORT Slot {
 
   friend struct internal::SignalTokenNode;
+  friend struct internal::TrackableLocking;
   friend class Trackable;
 
   template<typename ... ParamTypes> friend
   class Signal;
 
+  template<typename ... ParamTypes> friend
+  class FlatSignal;
+
  public:
 
   WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(Slot);
   Slot() = delete;
 
-  class Mark : public internal::SlotNode {
+  /**
+   * @brief Get the Signal object which is just calling this slot
+   *
+   * Returns nullptr if the signal is a LockedSignal, which is not used
+   * through its base class.
+   */
+  template<typename ... ParamTypes>
+  Signal<ParamTypes...> *signal() const;
 
-   public:
+  /**
+   * @brief The trackable object in which the slot method is being called
+   * @return The trackable object receiving signal
+   */
+  Trackable *binding_trackable() const {
+    return it_->binding->trackable;
+  }
 
-    Mark() = delete;
+ private:
 
-    explicit Mark(Slot *slot)
-        : slot_(slot) {}
+  typedef internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator IteratorType;
 
-    ~Mark() final = default;
+  Slot(const IteratorType &it, Slot *outer)
+      : it_(it), outer_(outer) {}
 
-    Slot *slot() const { return slot_; }
+  explicit Slot(internal::SignalTokenNode *token)
+      : it_(token) {}
 
-   private:
+  ~Slot() = default;
 
-    Slot *slot_ = nullptr;
+  /**
+   * @brief Move to the next token unless the current one was removed
+   */
+  Slot &operator++() {
+    if (removed_) {
+      removed_ = false;
+    } else {
+      ++it_;
+    }
+    return *this;
+  }
 
-  };
+  IteratorType it_;
+
+  /**
+   * @brief The emission of the same signal in progress when this one started
+   */
+  Slot *outer_ = nullptr;
+
+  /**
+   * @brief The token was removed and it_ has been moved to the next one
+   */
+  bool removed_ = false;
+
+  /**
+   * @brief The signal was destroyed in a slot method
+   */
+  bool destroyed_ = false;
+
+  /**
+   * @brief Called by EmitParallel(), UnbindSignal() only sets unbind_
+   */
+  bool deferred_ = false;
+
+  /**
+   * @brief UnbindSignal() was called with this slot in EmitParallel()
+   */
+  bool unbind_ = false;
+
+  /**
+   * @brief Iterates the dispatch list of the signal instead of the tokens,
+   * it_ is only the current token and is not moved when it's removed
+   */
+  bool flat_ = false;
+
+};
+
+/**
+ * @ingroup base
+ * @brief A handle to one connection returned by Signal::Connect()
+ *
+ * The handle is a pointer to the token of the connection, and the token
+ * points back to the handle. When the connection is removed in any way the
+ * token clears the handle, so Disconnect() is O(1) and always safe to call.
+ *
+ * A Connection can be moved but not copied. Destroying it does not break the
+ * connection, use ScopedConnection for that.
+ *
+ * A LockedSignal returns a LockedConnection instead, see threading.hpp.
+ */
+class WIZTK_EXPORT Connection {
+
+  friend struct internal::SignalTokenNode;
+
+  friend class LockedConnection;
+
+  template<typename ... ParamTypes> friend
+  class Signal;
+
+  template<typename ... ParamTypes> friend
+  class FlatSignal;
+
+  template<typename ... ParamTypes> friend
+  class ConcurrentSignal;
 
  public:
 
+  Connection() = default;
+
+  Connection(const Connection &) = delete;
+
+  Connection(Connection &&other) noexcept;
+
+  ~Connection();
+
+  Connection &operator=(const Connection &) = delete;
+
+  Connection &operator=(Connection &&other) noexcept;
+
   /**
-   * @brief Get the Signal object which is just calling this slot
+   * @brief Break the connection if it's still connected
    */
-  template<typename ... ParamTypes>
-  Signal<ParamTypes...> *signal() const {
-    return dynamic_cast<Signal<ParamTypes...> *>(it_->trackable);
+  void Disconnect();
+
+  /**
+   * @brief Forget the connection without breaking it
+   */
+  void Reset();
+
+  bool IsConnected() const {
+    return nullptr != token_;
+  }
+
+  explicit operator bool() const {
+    return nullptr != token_;
   }
 
   /**
-   * @brief The trackable object in which the slot method is being called
-   * @return The trackable object receiving signal
+   * @brief Block or unblock the connection if it's still connected
+   *
+   * A blocked connection stays in place and keeps its position, emitting the
+   * signal skips it.
    */
-  Trackable *binding_trackable() const {
-    return it_->binding->trackable;
+  void Block(bool blocked = true);
+
+  void Unblock() {
+    Block(false);
+  }
+
+  bool IsBlocked() const {
+    return nullptr != token_ && token_->blocked;
   }
 
  private:
 
-  typedef internal::InterRelatedDeque<internal::SignalTokenNode> DequeType;
-  typedef internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator IteratorType;
+  explicit Connection(internal::SignalTokenNode *token);
+
+  internal::SignalTokenNode *token_ = nullptr;
+
+};
+
+/**
+ * @ingroup base
+ * @brief A Connection which breaks the connection when destroyed
+ */
+class WIZTK_EXPORT ScopedConnection : public Connection {
+
+ public:
+
+  ScopedConnection() = default;
+
+  ScopedConnection(Connection &&other) noexcept
+      : Connection(std::move(other)) {}
+
+  ScopedConnection(ScopedConnection &&other) noexcept = default;
+
+  ~ScopedConnection() {
+    Disconnect();
+  }
+
+  ScopedConnection &operator=(Connection &&other) noexcept {
+    Disconnect();
+    Connection::operator=(std::move(other));
+    return *this;
+  }
+
+  ScopedConnection &operator=(ScopedConnection &&other) noexcept {
+    return operator=(static_cast<Connection &&>(other));
+  }
+
+  /**
+   * @brief Give up the ownership and return the Connection
+   */
+  Connection Release() {
+    return Connection(std::move(*this));
+  }
+
+};
+
+/**
+ * @ingroup base
+ * @brief Block a signal or connection in a scope
+ *
+ * The target can be a Signal, FlatSignal or Connection, it's blocked in the
+ * constructor and restored to the state before in the destructor:
+ *
+ * @code
+ * {
+ *   sigcxx::SignalBlocker blocker(model.changed());
+ *   model.Reset();  // changed() is not emitted to any slot
+ * }
+ * @endcode
+ */
+class WIZTK_EXPORT SignalBlocker {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(SignalBlocker);
+
+  template<typename T>
+  explicit SignalBlocker(T &target)
+      : target_(&target), block_stub_(&BlockStub<T>), was_blocked_(target.IsBlocked()) {
+    target.Block();
+  }
 
-  explicit Slot(DequeType *deque)
-      : deque_(deque), it_(deque->begin()), mark_(this) {}
+  ~SignalBlocker() {
+    block_stub_(target_, was_blocked_);
+  }
 
-  ~Slot() = default;
+  /**
+   * @brief Restore the state before this blocker until Reblock()
+   */
+  void Unblock() {
+    block_stub_(target_, was_blocked_);
+  }
 
-  Slot &operator++() {
-    if (ref_count_ > 0) {
-      --ref_count_;
-    } else {
-      ++it_;
-    }
-    return *this;
+  void Reblock() {
+    block_stub_(target_, true);
   }
 
-  Slot &operator--() {
-    if (ref_count_ > 0) {
-      --ref_count_;
-    } else {
-      --it_;
-    }
-    return *this;
+ private:
+
+  template<typename T>
+  static void BlockStub(void *target, bool blocked) {
+    static_cast<T *>(target)->Block(blocked);
   }
 
-  DequeType *deque_ = nullptr;
-  IteratorType it_;
-  size_t ref_count_ = 0;
-  Mark mark_;
+  void *target_;
+  void (*block_stub_)(void *, bool);
+  bool was_blocked_;
 
 };
 
-/**
- * @ingroup base
- * @brief A typedef of a pointer to a Slot.
- */
-typedef Slot *SLOT;
-
 /**
  * @ingroup base
  * @brief The basic class for an object which can provide slot methods
  */
 class WIZTK_EXPORT Trackable {
 
+  friend struct internal::SignalTokenNode;
+  friend struct internal::TrackableBindingNode;
+  friend struct internal::TrackableLocking;
+  friend class Slot;
+
   template<typename ... ParamTypes> friend
   class Signal;
 
+  template<typename ... ParamTypes> friend
+  class FlatSignal;
+
+  template<typename ... ParamTypes> friend
+  class ConcurrentSignal;
+
  public:
 
   /**
@@ -666,7 +1744,9 @@ class WIZTK_EXPORT Trackable {
   /**
    * @brief Count all connections
    */
-  size_t CountSignalBindings() const;
+  size_t CountSignalBindings() const {
+    return bindings_.size();
+  }
 
  protected:
 
@@ -679,6 +1759,11 @@ class WIZTK_EXPORT Trackable {
 
   /**
     * @brief Break the all connections to this object
+    *
+    * The bindings are detached from this object at once, but each token is
+    * still removed from its own signal one by one, as the signals may be
+    * emitting or indexing it. Unlike Signal::DisconnectAll(), the cost is
+    * that of disconnecting each connection.
     */
   void UnbindAllSignals();
 
@@ -718,22 +1803,59 @@ class WIZTK_EXPORT Trackable {
     trackable->bindings_.insert(binding, index);
   }
 
+  /**
+   * @brief Called when a token of this object (if it's a signal) is being destroyed
+   *
+   * Signal overrides this to keep the emission in progress valid.
+   */
+  virtual void OnTokenRemoved(internal::SignalTokenNode * /* token */) {}
+
+  /**
+   * @brief Called when a token of this object (if it's a signal) is blocked
+   * or unblocked
+   */
+  virtual void OnTokenBlocked(internal::SignalTokenNode * /* token */) {}
+
+  /**
+   * @brief Returns the address of internal::SignalTypeTag<ParamTypes...>::id
+   * if this is a Signal<ParamTypes...>, or nullptr
+   */
+  virtual const void *GetSignalTypeTag() const {
+    return nullptr;
+  }
+
+  /**
+   * @brief Returns the lock of a thread-safe subclass, or nullptr
+   *
+   * Only used by the locked classes in threading.hpp.
+   */
+  virtual internal::Lockable *GetLock() const {
+    return nullptr;
+  }
+
   internal::InterRelatedDeque<internal::TrackableBindingNode> bindings_;
 
 };
 
+template<typename ... ParamTypes>
+Signal<ParamTypes...> *Slot::signal() const {
+  Trackable *trackable = it_->trackable;
+  if (trackable->GetSignalTypeTag() != &internal::SignalTypeTag<ParamTypes...>::id) return nullptr;
+  return static_cast<Signal<ParamTypes...> *>(trackable);
+}
+
 template<typename T, typename ... ParamTypes>
 void Trackable::UnbindAllSignalsTo(void (T::*method)(ParamTypes...)) {
   internal::TrackableBindingNode *tmp = nullptr;
-  internal::DelegateToken<ParamTypes...> *delegate_token = nullptr;
+  const void *object = (T *) this;
+  auto generic_method = reinterpret_cast<internal::GenericMethodPointer>(method);
 
   auto it = bindings_.rbegin();
   while (it != bindings_.rend()) {
     tmp = it.get();
     ++it;
 
-    delegate_token = dynamic_cast<internal::DelegateToken<ParamTypes...> * > (tmp->token);
-    if (delegate_token && (delegate_token->delegate().template Equal<T>((T *) this, method))) {
+    if (tmp->token->IsBoundTo(object, generic_method)) {
       delete tmp;
     }
   }
@@ -742,12 +1864,11 @@ void Trackable::UnbindAllSignalsTo(void (T::*method)(ParamTypes...)) {
 template<typename T, typename ... ParamTypes>
 size_t Trackable::CountSignalBindings(void (T::*method)(ParamTypes...)) const {
   size_t count = 0;
-  internal::DelegateToken<ParamTypes...> *delegate_token = nullptr;
+  const void *object = (const T *) this;
+  auto generic_method = reinterpret_cast<internal::GenericMethodPointer>(method);
 
   for (auto it = bindings_.cbegin(); it != bindings_.cend(); ++it) {
-    delegate_token =
-        dynamic_cast<internal::DelegateToken<ParamTypes...> * > (it.get()->token);
-    if (delegate_token && (delegate_token->delegate().template Equal<T>((T *) this, method))) {
+    if (it.get()->token->IsBoundTo(object, generic_method)) {
       count++;
     }
   }
@@ -757,11 +1878,25 @@ size_t Trackable::CountSignalBindings(void (T::*method)(ParamTypes...)) const {
 /**
  * @ingroup base
  * @brief A template class which can emit signal(s)
+ *
+ * An unconnected signal takes two cache lines and allocates nothing. The
+ * token and binding of each connection are created together in one block of
+ * the node pool, which is taken from a thread local cache without locking.
+ * The indexes and the dispatch list are added behind one pointer only when
+ * the fan-out grows or signals are chained.
+ *
+ * A subclass can store connections in cells of its own (see StaticSignal).
+ * Where a connection is stored does not change its position, Connect() and
+ * Disconnect() by index work the same for all of them.
  */
 template<typename ... ParamTypes>
 class WIZTK_EXPORT Signal : public Trackable {
 
   friend class Trackable;
+  friend class internal::SignalToken<ParamTypes...>;
+
+  template<typename Policy, typename ... SignalParamTypes> friend
+  class LockedSignal;
 
  public:
 
@@ -769,23 +1904,93 @@ class WIZTK_EXPORT Signal : public Trackable {
 
   Signal() = default;
 
-  ~Signal() final {
-    DisconnectAll();
-  }
+  ~Signal() override;
 
   /**
    * @brief Connect this signal to a slot method in a observer
    */
   template<typename T>
-  void Connect(T *obj, void (T::*method)(ParamTypes..., SLOT), int index = -1);
+  Connection Connect(T *obj, void (T::*method)(ParamTypes..., SLOT), int index = -1) {
+    return Connect<T, ParamTypes..., SLOT>(obj, method, index);
+  }
+
+  /**
+   * @brief Connect this signal to a slot method with compatible parameter types
+   *
+   * Arguments given to Emit() are passed to slot methods by reference, so a
+   * slot method can take a const reference (or a non-const reference) to the
+   * parameter to avoid copying it for each connection.
+   */
+  template<typename T, typename ... SlotParamTypes>
+  Connection Connect(T *obj, void (T::*method)(SlotParamTypes...), int index = -1);
+
+  Connection Connect(Signal<ParamTypes...> &other, int index = -1);
+
+  /**
+   * @brief Connect this signal to a batch slot method
+   *
+   * A batch slot method receives all argument tuples given to EmitBatch() in
+   * one call. When the signal is emitted by Emit(), it's called with one tuple
+   * copied from the arguments.
+   *
+   * Use the same method pointer to disconnect or check the connection.
+   */
+  template<typename T>
+  Connection ConnectBatch(T *obj, void (T::*method)(std::tuple<ParamTypes...> *, size_t, SLOT), int index = -1);
+
+  /**
+   * @brief Connect this signal to a slot method called in the thread of an
+   * executor
+   *
+   * Emitting the signal copies the arguments into a Task posted to the
+   * executor, which calls the slot method later with a nullptr SLOT. When the
+   * connection is removed, including when the observer is destroyed, the
+   * calls still in queue are skipped. Destroy the observer in the thread of
+   * the executor. The executor must outlive the connection and its tasks.
+   *
+   * The connection is disconnected and checked by the object and method as
+   * any other.
+   */
+  template<typename T, typename ... SlotParamTypes>
+  Connection Connect(T *obj, void (T::*method)(SlotParamTypes...), Executor &executor, int index = -1);
 
-  void Connect(Signal<ParamTypes...> &other, int index = -1);
+  /**
+   * @brief The function merging the arguments of an emission into the ones
+   * still pending in a coalescing connection
+   */
+  typedef typename internal::CoalescedTarget<ParamTypes...>::MergeFunction MergeFunction;
+
+  /**
+   * @brief Connect this signal to a slot method called in the thread of an
+   * executor, with the emissions not delivered yet coalesced into one
+   * @param merge Merges the arguments of an emission into the pending ones,
+   * or nullptr to keep the latest arguments only
+   *
+   * At most one call per connection is in the queue of the executor: an
+   * emission while it's pending changes its arguments instead of posting
+   * another task, so the queue and the work of the executor do not grow with
+   * the rate of emission. No memory is allocated per emission.
+   *
+   * Otherwise the same as a queued connection made by Connect() with an
+   * executor. The executor must run the tasks in one thread.
+   */
+  template<typename T, typename ... SlotParamTypes>
+  Connection ConnectCoalesced(T *obj,
+                              void (T::*method)(SlotParamTypes...),
+                              Executor &executor,
+                              MergeFunction merge = nullptr,
+                              int index = -1);
 
   /**
    * @brief Disconnect all delegates to a method
    */
   template<typename T>
-  void DisconnectAll(T *obj, void (T::*method)(ParamTypes..., SLOT));
+  void DisconnectAll(T *obj, void (T::*method)(ParamTypes..., SLOT)) {
+    DisconnectAll<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  void DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...));
 
   /**
    * @brief Disconnect all signals
@@ -804,7 +2009,12 @@ class WIZTK_EXPORT Signal : public Trackable {
    * By the default parameters this disconnect the last delegate to a method.
    */
   template<typename T>
-  int Disconnect(T *obj, void (T::*method)(ParamTypes..., SLOT), int start_pos = -1, int counts = 1);
+  int Disconnect(T *obj, void (T::*method)(ParamTypes..., SLOT), int start_pos = -1, int counts = 1) {
+    return Disconnect<T, ParamTypes..., SLOT>(obj, method, start_pos, counts);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  int Disconnect(T *obj, void (T::*method)(SlotParamTypes...), int start_pos = -1, int counts = 1);
 
   /**
    * @brief Disconnect connections to a signal by given start position and counts
@@ -832,89 +2042,495 @@ class WIZTK_EXPORT Signal : public Trackable {
   void DisconnectAll();
 
   template<typename T>
-  bool IsConnectedTo(T *obj, void (T::*method)(ParamTypes..., SLOT)) const;
+  bool IsConnectedTo(T *obj, void (T::*method)(ParamTypes..., SLOT)) const {
+    return IsConnectedTo<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  bool IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const;
 
   bool IsConnectedTo(const Signal<ParamTypes...> &other) const;
 
   bool IsConnectedTo(const Trackable *obj) const;
 
   template<typename T>
-  int CountConnections(T *obj, void (T::*method)(ParamTypes..., SLOT)) const;
+  int CountConnections(T *obj, void (T::*method)(ParamTypes..., SLOT)) const {
+    return CountConnections<T, ParamTypes..., SLOT>(obj, method);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  int CountConnections(T *obj, void (T::*method)(SlotParamTypes...)) const;
 
   int CountConnections(const Signal<ParamTypes...> &other) const;
 
-  int CountConnections() const;
+  int CountConnections() const {
+    return static_cast<int>(tokens_.size());
+  }
+
+  /**
+   * @brief Returns if this signal has no connection
+   */
+  bool empty() const {
+    return tokens_.empty();
+  }
+
+  /**
+   * @brief Emit this signal
+   *
+   * The arguments are materialized once here, then every connected slot
+   * method and chained signal receives a reference to them.
+   *
+   * A connection added in a slot method after the one being called is
+   * called in the same emission, unless this signal has chained signals:
+   * then the emission iterates a dispatch list built before it starts, and
+   * connections added to this or any chained signal are called from the next
+   * emission on. Connections removed or blocked in a slot method are not
+   * called either way.
+   */
+  void Emit(ParamTypes ... Args) {
+    Dispatch(Args...);
+  }
+
+  void operator()(ParamTypes ... Args) {
+    Emit(std::forward<ParamTypes>(Args)...);
+  }
+
+  /**
+   * @brief Block or unblock this signal
+   *
+   * Emitting a blocked signal, directly or through a chained signal, does
+   * nothing. The connections are kept as they are.
+   */
+  void Block(bool blocked = true);
+
+  void Unblock() {
+    Block(false);
+  }
+
+  bool IsBlocked() const {
+    return blocked_;
+  }
+
+  /**
+   * @brief Emit this signal once for each tuple of arguments
+   * @param tuples A contiguous array of argument tuples
+   * @param count The number of tuples
+   *
+   * The batch is dispatched slot-major: each connection is called for all
+   * tuples before the next connection, a batch slot method is called only
+   * once with the whole array. This is different from calling Emit() in a
+   * loop only in the order of calls between different slot methods.
+   *
+   * If a connection is removed in a slot method, it's not called for the
+   * remaining tuples. Connections added after the current one are called with
+   * the whole batch.
+   */
+  void EmitBatch(std::tuple<ParamTypes...> *tuples, size_t count);
+
+  /**
+   * @brief Emit this signal with the connections split in chunks run on a
+   * thread pool
+   * @param pool The pool running the chunks, this thread helps until all are
+   * done
+   *
+   * Made for signals with many connections and slot methods doing enough
+   * work to pay for waking the workers, the order of calls is not defined.
+   * Connections of chained signals are called as well, but not queued
+   * connections made in other threads.
+   *
+   * The arguments are shared by all threads, a signal with a non-const
+   * reference parameter cannot be emitted this way.
+   *
+   * The slot methods are called in different threads at the same time. They
+   * must not connect, disconnect, emit or destroy this signal, chained
+   * signals or observers. The only change allowed is UnbindSignal() with the
+   * SLOT argument: the connection is removed after all slot methods returned,
+   * before this function returns.
+   */
+  void EmitParallel(ThreadPool &pool, ParamTypes ... Args);
+
+ protected:
+
+  typedef internal::ConnectionCell<ParamTypes...> CellType;
+
+  /**
+   * @brief Returns a free cell for a new connection, or nullptr to allocate it
+   *
+   * Override this in a subclass which provides cells, the cells must be
+   * valid until DisconnectAll() is called in the destructor of the subclass.
+   */
+  virtual CellType *FindFreeCell() {
+    return nullptr;
+  }
+
+ private:
+
+  typedef internal::DelegateToken<ParamTypes..., SLOT> DelegateTokenType;
+  typedef typename DelegateTokenType::DelegateType DelegateType;
+
+  void OnTokenRemoved(internal::SignalTokenNode *token) final;
+
+  void OnTokenBlocked(internal::SignalTokenNode *token) final;
+
+  const void *GetSignalTypeTag() const override {
+    return &internal::SignalTypeTag<ParamTypes...>::id;
+  }
+
+  void OnTokenAdded(internal::SignalTokenNode *token);
+
+  /**
+   * @brief Mark the dispatch lists of this signal and all signals forwarding
+   * to it as out of date
+   * @param removed A token being removed, or nullptr
+   */
+  void InvalidateDispatch(const internal::SignalTokenNode *removed);
+
+  /**
+   * @brief Rebuild the dispatch list
+   */
+  void CompileDispatch();
+
+  static void CompileDispatch(Signal *signal, std::vector<internal::SignalTokenNode *> *list);
+
+  /**
+   * @brief Call the tokens in the dispatch list
+   */
+  void DispatchFlat(typename internal::ArgRef<ParamTypes>::type ... Args);
+
+  /**
+   * @brief Create a token and a binding in a free cell or on the heap
+   */
+  template<typename TokenType, typename ArgType>
+  void NewConnection(ArgType &&arg,
+                     internal::SignalTokenNode *&token,
+                     internal::TrackableBindingNode *&binding) {
+    NewConnection<TokenType>(std::forward<ArgType>(arg), token, binding,
+                             typename CellType::template Fits<TokenType>());
+  }
+
+  template<typename TokenType, typename ArgType>
+  void NewConnection(ArgType &&arg,
+                     internal::SignalTokenNode *&token,
+                     internal::TrackableBindingNode *&binding,
+                     std::true_type /* fits in a cell */);
+
+  template<typename TokenType, typename ArgType>
+  void NewConnection(ArgType &&arg,
+                     internal::SignalTokenNode *&token,
+                     internal::TrackableBindingNode *&binding,
+                     std::false_type /* fits in a cell */);
+
+  /**
+   * @brief Returns the side table, allocate it if there's none
+   */
+  internal::SignalSideTable *side_table() {
+    if (nullptr == side_) side_ = new internal::SignalSideTable;
+    return side_;
+  }
+
+  /**
+   * @brief Returns if the dispatch list is being iterated
+   */
+  bool IsDispatching() const {
+    return (nullptr != side_) && (side_->dispatching > 0);
+  }
+
+  void Dispatch(typename internal::ArgRef<ParamTypes>::type ... Args);
+
+  struct ParallelEmission;
+
+  /**
+   * @brief The range function of EmitParallel()
+   */
+  static void EmitRange(void *context, size_t begin, size_t end);
+
+  static inline void PushFrontToken(Signal *signal, internal::SignalTokenNode *token) {
+    _ASSERT(nullptr == token->trackable);
+    token->trackable = signal;
+    signal->tokens_.push_front(token);
+    signal->OnTokenAdded(token);
+  }
+
+  static inline void PushBackToken(Signal *signal, internal::SignalTokenNode *token) {
+    _ASSERT(nullptr == token->trackable);
+    token->trackable = signal;
+    signal->tokens_.push_back(token);
+    signal->OnTokenAdded(token);
+  }
+
+  static inline void InsertToken(Signal *signal, internal::SignalTokenNode *token, int index = 0) {
+    _ASSERT(nullptr == token->trackable);
+    token->trackable = signal;
+
+    // Same position rule as InterRelatedDeque::insert(), but find the token
+    // at the position with the index if there's one
+    size_t count = signal->tokens_.size();
+    size_t position = count;
+    if (index >= 0) {
+      if (static_cast<size_t>(index) < count) position = static_cast<size_t>(index);
+    } else {
+      size_t offset = static_cast<size_t>(-(index + 1));
+      position = offset < count ? count - offset : 0;
+    }
+
+    if (position == count) {
+      signal->tokens_.push_back(token);
+    } else {
+      signal->tokens_.insert_before(token, signal->TokenAt(position));
+    }
+    signal->OnTokenAdded(token);
+  }
+
+  /**
+   * @brief Get the token at the given position
+   *
+   * Use the order statistic index once there are more than kIndexThreshold
+   * tokens, otherwise walk the list.
+   */
+  internal::SignalTokenNode *TokenAt(size_t position);
+
+  void BuildPositionIndex();
+
+  /**
+   * @brief Build the method index if there are more than kIndexThreshold
+   * tokens and it's not built yet
+   * @return If the method index can be used
+   *
+   * The index is built by the first lookup, not when connecting, so a signal
+   * which is only connected, emitted and destroyed never pays for it.
+   */
+  bool UseMethodIndex() const;
+
+  /**
+   * @brief Returns the index entry of a token, allocate it if there's none
+   */
+  static internal::TokenIndexEntry *IndexEntryOf(internal::SignalTokenNode *token) {
+    if (nullptr == token->index_entry) token->index_entry = new internal::TokenIndexEntry(token);
+    return token->index_entry;
+  }
+
+  /**
+   * @brief Remove a token from the indexes and free its entry
+   */
+  void Unindex(internal::SignalTokenNode *token);
+
+  /**
+   * @brief Find the tokens calling the method of the object in the method index
+   * @param tokens Append the tokens found to this vector if it's not nullptr
+   * @return The number of tokens found
+   */
+  size_t FindTokens(const void *object,
+                    internal::GenericMethodPointer method,
+                    std::vector<internal::SignalTokenNode *> *tokens = nullptr) const;
+
+  /**
+   * @brief Disconnect the tokens found in the method index from the start
+   * position, the same as walking the list in Disconnect()
+   */
+  int DisconnectTokens(std::vector<internal::SignalTokenNode *> *tokens, int start_pos, int counts);
+
+  /**
+   * @brief Get the iterator to the start position used in Disconnect()
+   */
+  internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator IteratorAt(int start_pos) {
+    _ASSERT(start_pos >= 0);
+    if (static_cast<size_t>(start_pos) >= tokens_.size()) return tokens_.end();
+    return internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator(TokenAt(static_cast<size_t>(start_pos)));
+  }
+
+  /**
+   * @brief Get the reverse iterator to the start position used in Disconnect()
+   */
+  internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator ReverseIteratorAt(int start_pos) {
+    _ASSERT(start_pos < 0);
+    size_t offset = static_cast<size_t>(-(start_pos + 1));
+    if (offset >= tokens_.size()) return tokens_.rend();
+    return internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator(
+        TokenAt(tokens_.size() - 1 - offset));
+  }
+
+  /**
+   * @brief The slot method of a SignalToken, used for chaining signals
+   */
+  void Forward(typename internal::ArgRef<ParamTypes>::type ... Args, SLOT /* slot */) {
+    Dispatch(Args...);
+  }
+
+  static constexpr size_t kIndexThreshold = 32;
+
+  internal::InterRelatedDeque<internal::SignalTokenNode> tokens_;
+
+  /**
+   * @brief The innermost emission in progress, through the tokens or the
+   * dispatch list
+   */
+  Slot *emitting_ = nullptr;
+
+  /**
+   * @brief The indexes and the dispatch list, nullptr until a signal with many
+   * connections is looked up or a signal with chained signals is emitted
+   *
+   * The indexes are built by lookups on a signal with more than
+   * kIndexThreshold connections, and dropped when all connections are
+   * removed. The dispatch list is built on demand for a signal with
+   * SignalTokens.
+   */
+  internal::SignalSideTable *side_ = nullptr;
+
+  /**
+   * @brief The number of SignalTokens in tokens_
+   */
+  uint32_t forward_count_ = 0;
+
+  bool invalidating_ = false;
+
+  bool blocked_ = false;
+
+};
+
+// Signal implementation:
+
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief Run the range function of Signal::EmitParallel() in the pool, in
+ * ranges sized for the number of threads
+ */
+WIZTK_EXPORT void ParallelEmit(ThreadPool &pool, size_t count, void (*function)(void *, size_t, size_t), void *context);
+
+template<typename ... ParamTypes, size_t ... I>
+inline void InvokeWithTuple(const CallableToken<ParamTypes..., SLOT> *token,
+                            std::tuple<ParamTypes...> &tuple,
+                            SLOT slot,
+                            std::index_sequence<I...>) {
+  token->Invoke(std::get<I>(tuple)..., slot);
+}
+
+} // namespace internal
 
-  void Emit(ParamTypes ... Args);
+template<typename ... ParamTypes>
+Signal<ParamTypes...>::~Signal() {
+  DisconnectAll();
 
-  void operator()(ParamTypes ... Args) {
-    Emit(Args...);
+  // Tell the emissions in progress to stop at once
+  for (Slot *slot = emitting_; slot; slot = slot->outer_) {
+    slot->destroyed_ = true;
   }
 
- private:
-
-  static inline void PushFrontToken(Signal *signal, internal::SignalTokenNode *token) {
-    _ASSERT(nullptr == token->trackable);
-    token->trackable = signal;
-    signal->tokens_.push_front(token);
-  }
+  delete side_;
+}
 
-  static inline void PushBackToken(Signal *signal, internal::SignalTokenNode *token) {
-    _ASSERT(nullptr == token->trackable);
-    token->trackable = signal;
-    signal->tokens_.push_back(token);
-  }
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+Connection Signal<ParamTypes...>::Connect(T *obj, void (T::*method)(SlotParamTypes...), int index) {
+  static_assert(sizeof...(SlotParamTypes) == sizeof...(ParamTypes) + 1,
+                "The slot method must take the same number of parameters as the signal, plus a SLOT");
 
-  static inline void InsertToken(Signal *signal, internal::SignalTokenNode *token, int index = 0) {
-    _ASSERT(nullptr == token->trackable);
-    token->trackable = signal;
-    signal->tokens_.insert(token, index);
-  }
+  internal::SignalTokenNode *token = nullptr;
+  internal::TrackableBindingNode *binding = nullptr;
+  NewConnection<DelegateTokenType>(DelegateType::FromMethod(obj, method), token, binding);
 
-  internal::InterRelatedDeque<internal::SignalTokenNode> tokens_;
+  Link(token, binding);
+  InsertToken(this, token, index);
+  PushBackBinding(obj, binding);  // always push back binding, don't care about the position in observer
+  return Connection(token);
+}
 
-};
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+Connection Signal<ParamTypes...>::Connect(T *obj,
+                                          void (T::*method)(SlotParamTypes...),
+                                          Executor &executor,
+                                          int index) {
+  static_assert(sizeof...(SlotParamTypes) == sizeof...(ParamTypes) + 1,
+                "The slot method must take the same number of parameters as the signal, plus a SLOT");
+  typedef internal::QueuedToken<ParamTypes...> QueuedTokenType;
+  typedef typename QueuedTokenType::TargetType TargetType;
+
+  internal::SignalTokenNode *token = nullptr;
+  internal::TrackableBindingNode *binding = nullptr;
+  TargetType *target = TargetType::New(TargetType::DelegateType::FromMethod(obj, method), &executor);
+  NewConnection<QueuedTokenType>(target, token, binding);
 
-// Signal implementation:
+  Link(token, binding);
+  InsertToken(this, token, index);
+  PushBackBinding(obj, binding);  // always push back binding, don't care about the position in observer
+  return Connection(token);
+}
 
 template<typename ... ParamTypes>
-template<typename T>
-void Signal<ParamTypes...>::Connect(T *obj, void (T::*method)(ParamTypes..., SLOT), int index) {
-  Delegate<void(ParamTypes..., SLOT)> d =
-      Delegate<void(ParamTypes..., SLOT)>::template FromMethod<T>(obj, method);
-  auto *token = new internal::DelegateToken<ParamTypes..., SLOT>(d);
-  auto *binding = new internal::TrackableBindingNode;
+template<typename T, typename ... SlotParamTypes>
+Connection Signal<ParamTypes...>::ConnectCoalesced(T *obj,
+                                                   void (T::*method)(SlotParamTypes...),
+                                                   Executor &executor,
+                                                   MergeFunction merge,
+                                                   int index) {
+  static_assert(sizeof...(SlotParamTypes) == sizeof...(ParamTypes) + 1,
+                "The slot method must take the same number of parameters as the signal, plus a SLOT");
+  typedef internal::CoalescedToken<ParamTypes...> CoalescedTokenType;
+  typedef typename CoalescedTokenType::TargetType TargetType;
+
+  internal::SignalTokenNode *token = nullptr;
+  internal::TrackableBindingNode *binding = nullptr;
+  TargetType *target = TargetType::New(TargetType::DelegateType::FromMethod(obj, method), &executor, merge);
+  NewConnection<CoalescedTokenType>(target, token, binding);
 
   Link(token, binding);
   InsertToken(this, token, index);
   PushBackBinding(obj, binding);  // always push back binding, don't care about the position in observer
+  return Connection(token);
 }
 
 template<typename ... ParamTypes>
-void Signal<ParamTypes...>::Connect(Signal<ParamTypes...> &other, int index) {
-  auto *token = new internal::SignalToken<ParamTypes...>(
-      other);
-  auto *binding = new internal::TrackableBindingNode;
+Connection Signal<ParamTypes...>::Connect(Signal<ParamTypes...> &other, int index) {
+  internal::SignalTokenNode *token = nullptr;
+  internal::TrackableBindingNode *binding = nullptr;
+  NewConnection<internal::SignalToken<ParamTypes...>>(other, token, binding);
 
   Link(token, binding);
   InsertToken(this, token, index);
   PushBackBinding(&other, binding);  // always push back binding, don't care about the position in observer
+  return Connection(token);
 }
 
 template<typename ... ParamTypes>
 template<typename T>
-void Signal<ParamTypes...>::DisconnectAll(T *obj, void (T::*method)(ParamTypes..., SLOT)) {
-  internal::DelegateToken<ParamTypes..., SLOT> *delegate_token = nullptr;
+Connection Signal<ParamTypes...>::ConnectBatch(T *obj,
+                                               void (T::*method)(std::tuple<ParamTypes...> *, size_t, SLOT),
+                                               int index) {
+  typedef internal::BatchToken<ParamTypes...> BatchTokenType;
+
+  internal::SignalTokenNode *token = nullptr;
+  internal::TrackableBindingNode *binding = nullptr;
+  NewConnection<BatchTokenType>(BatchTokenType::BatchDelegateType::FromMethod(obj, method), token, binding);
+
+  Link(token, binding);
+  InsertToken(this, token, index);
+  PushBackBinding(obj, binding);  // always push back binding, don't care about the position in observer
+  return Connection(token);
+}
+
+template<typename ... ParamTypes>
+template<typename T, typename ... SlotParamTypes>
+void Signal<ParamTypes...>::DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...)) {
+  auto generic_method = reinterpret_cast<internal::GenericMethodPointer>(method);
   internal::SignalTokenNode *tmp = nullptr;
 
+  if (UseMethodIndex()) {
+    std::vector<internal::SignalTokenNode *> tokens;
+    FindTokens(obj, generic_method, &tokens);
+    for (internal::SignalTokenNode *token : tokens) delete token;
+    return;
+  }
+
   internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator it = tokens_.rbegin();
   while (it != tokens_.rend()) {
     tmp = it.get();
     ++it;
 
     if (tmp->binding->trackable == obj) {
-      delegate_token = dynamic_cast<internal::DelegateToken<ParamTypes..., SLOT> * > (tmp);
-      if (delegate_token && (delegate_token->delegate().template Equal<T>(obj, method))) {
+      if (tmp->IsBoundTo(obj, generic_method)) {
         delete tmp;
       }
     }
@@ -932,7 +2548,7 @@ void Signal<ParamTypes...>::DisconnectAll(Signal<ParamTypes...> &other) {
     ++it;
 
     if (tmp->binding->trackable == (&other)) {
-      signal_token = dynamic_cast<internal::SignalToken<ParamTypes...> * > (tmp);
+      signal_token = internal::SignalTokenCast<ParamTypes...>(tmp);
       if (signal_token && (signal_token->signal() == (&other))) {
         delete tmp;
       }
@@ -941,26 +2557,27 @@ void Signal<ParamTypes...>::DisconnectAll(Signal<ParamTypes...> &other) {
 }
 
 template<typename ... ParamTypes>
-template<typename T>
-int Signal<ParamTypes...>::Disconnect(T *obj, void (T::*method)(ParamTypes..., SLOT), int start_pos, int counts) {
-  internal::DelegateToken<ParamTypes..., SLOT> *delegate_token = nullptr;
+template<typename T, typename ... SlotParamTypes>
+int Signal<ParamTypes...>::Disconnect(T *obj, void (T::*method)(SlotParamTypes...), int start_pos, int counts) {
+  auto generic_method = reinterpret_cast<internal::GenericMethodPointer>(method);
   internal::SignalTokenNode *tmp = nullptr;
   int ret_count = 0;
 
+  if (UseMethodIndex()) {
+    std::vector<internal::SignalTokenNode *> tokens;
+    FindTokens(obj, generic_method, &tokens);
+    return DisconnectTokens(&tokens, start_pos, counts);
+  }
+
   if (start_pos >= 0) {
-    internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin();
-    while ((it != tokens_.end()) && (start_pos > 0)) {
-      ++it;
-      start_pos--;
-    }
+    internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = IteratorAt(start_pos);
 
     while (it != tokens_.end()) {
       tmp = it.get();
       ++it;
 
       if (tmp->binding->trackable == obj) {
-        delegate_token = dynamic_cast<internal::DelegateToken<ParamTypes..., SLOT> * > (tmp);
-        if (delegate_token && (delegate_token->delegate().template Equal<T>(obj, method))) {
+        if (tmp->IsBoundTo(obj, generic_method)) {
           ret_count++;
           counts--;
           delete tmp;
@@ -969,19 +2586,14 @@ int Signal<ParamTypes...>::Disconnect(T *obj, void (T::*method)(ParamTypes..., S
       if (counts == 0) break;
     }
   } else {
-    internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator it = tokens_.rbegin();
-    while ((it != tokens_.rend()) && (start_pos < -1)) {
-      ++it;
-      start_pos++;
-    }
+    internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator it = ReverseIteratorAt(start_pos);
 
     while (it != tokens_.rend()) {
       tmp = it.get();
       ++it;
 
       if (tmp->binding->trackable == obj) {
-        delegate_token = dynamic_cast<internal::DelegateToken<ParamTypes..., SLOT> * > (tmp);
-        if (delegate_token && (delegate_token->delegate().template Equal<T>(obj, method))) {
+        if (tmp->IsBoundTo(obj, generic_method)) {
           ret_count++;
           counts--;
           delete tmp;
@@ -1001,18 +2613,14 @@ int Signal<ParamTypes...>::Disconnect(Signal<ParamTypes...> &other, int start_po
   int ret_count = 0;
 
   if (start_pos >= 0) {
-    internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin();
-    while ((it != tokens_.end()) && (start_pos > 0)) {
-      ++it;
-      start_pos--;
-    }
+    internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = IteratorAt(start_pos);
 
     while (it != tokens_.end()) {
       tmp = it.get();
       ++it;
 
       if (tmp->binding->trackable == (&other)) {
-        signal_token = dynamic_cast<internal::SignalToken<ParamTypes...> * > (tmp);
+        signal_token = internal::SignalTokenCast<ParamTypes...>(tmp);
         if (signal_token && (signal_token->signal() == (&other))) {
           ret_count++;
           counts--;
@@ -1023,18 +2631,14 @@ int Signal<ParamTypes...>::Disconnect(Signal<ParamTypes...> &other, int start_po
     }
 
   } else {
-    internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator it = tokens_.rbegin();
-    while ((it != tokens_.rend()) && (start_pos < -1)) {
-      ++it;
-      start_pos++;
-    }
+    internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator it = ReverseIteratorAt(start_pos);
 
     while (it != tokens_.rend()) {
       tmp = it.get();
       ++it;
 
       if (tmp->binding->trackable == (&other)) {
-        signal_token = dynamic_cast<internal::SignalToken<ParamTypes...> * > (tmp);
+        signal_token = internal::SignalTokenCast<ParamTypes...>(tmp);
         if (signal_token && (signal_token->signal() == (&other))) {
           ret_count++;
           counts--;
@@ -1055,11 +2659,7 @@ int Signal<ParamTypes...>::Disconnect(int start_pos, int counts) {
   int ret_count = 0;
 
   if (start_pos >= 0) {
-    internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin();
-    while ((it != tokens_.end()) && (start_pos > 0)) {
-      ++it;
-      start_pos--;
-    }
+    internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = IteratorAt(start_pos);
 
     while (it != tokens_.end()) {
       tmp = it.get();
@@ -1073,11 +2673,7 @@ int Signal<ParamTypes...>::Disconnect(int start_pos, int counts) {
     }
 
   } else {
-    internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator it = tokens_.rbegin();
-    while ((it != tokens_.rend()) && (start_pos < -1)) {
-      ++it;
-      start_pos++;
-    }
+    internal::InterRelatedDeque<internal::SignalTokenNode>::ReverseIterator it = ReverseIteratorAt(start_pos);
 
     while (it != tokens_.rend()) {
       tmp = it.get();
@@ -1096,15 +2692,16 @@ int Signal<ParamTypes...>::Disconnect(int start_pos, int counts) {
 }
 
 template<typename ... ParamTypes>
-template<typename T>
-bool Signal<ParamTypes...>::IsConnectedTo(T *obj, void (T::*method)(ParamTypes..., SLOT)) const {
-  internal::DelegateToken<ParamTypes..., SLOT> *delegate_token = nullptr;
+template<typename T, typename ... SlotParamTypes>
+bool Signal<ParamTypes...>::IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const {
+  auto generic_method = reinterpret_cast<internal::GenericMethodPointer>(method);
+
+  if (UseMethodIndex()) return FindTokens(obj, generic_method) > 0;
 
   for (internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin(); it != tokens_.end();
        ++it) {
     if (it->binding->trackable == obj) {
-      delegate_token = dynamic_cast<internal::DelegateToken<ParamTypes..., SLOT> * > (it.get());
-      if (delegate_token && (delegate_token->delegate().template Equal<T>(obj, method))) {
+      if (it.get()->IsBoundTo(obj, generic_method)) {
         return true;
       }
     }
@@ -1119,7 +2716,7 @@ bool Signal<ParamTypes...>::IsConnectedTo(const Signal<ParamTypes...> &other) co
   for (internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin(); it != tokens_.end();
        ++it) {
     if (it->binding->trackable == (&other)) {
-      signal_token = dynamic_cast<internal::SignalToken<ParamTypes...> * > (it.get());
+      signal_token = internal::SignalTokenCast<ParamTypes...>(it.get());
       if (signal_token && (signal_token->signal() == (&other))) {
         return true;
       }
@@ -1146,16 +2743,17 @@ bool Signal<ParamTypes...>::IsConnectedTo(const Trackable *obj) const {
 }
 
 template<typename ... ParamTypes>
-template<typename T>
-int Signal<ParamTypes...>::CountConnections(T *obj, void (T::*method)(ParamTypes..., SLOT)) const {
+template<typename T, typename ... SlotParamTypes>
+int Signal<ParamTypes...>::CountConnections(T *obj, void (T::*method)(SlotParamTypes...)) const {
   int count = 0;
-  internal::DelegateToken<ParamTypes..., SLOT> *delegate_token = nullptr;
+  auto generic_method = reinterpret_cast<internal::GenericMethodPointer>(method);
+
+  if (UseMethodIndex()) return static_cast<int>(FindTokens(obj, generic_method));
 
   for (internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin(); it != tokens_.end();
        ++it) {
     if (it->binding->trackable == obj) {
-      delegate_token = dynamic_cast<internal::DelegateToken<ParamTypes..., SLOT> * > (it.get());
-      if (delegate_token && (delegate_token->delegate().template Equal<T>(obj, method))) {
+      if (it.get()->IsBoundTo(obj, generic_method)) {
         count++;
       }
     }
@@ -1171,7 +2769,7 @@ int Signal<ParamTypes...>::CountConnections(const Signal<ParamTypes...> &other)
   for (internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin(); it != tokens_.end();
        ++it) {
     if (it->binding->trackable == (&other)) {
-      signal_token = dynamic_cast<internal::SignalToken<ParamTypes...> * > (it.get());
+      signal_token = internal::SignalTokenCast<ParamTypes...>(it.get());
       if (signal_token && (signal_token->signal() == (&other))) {
         count++;
       }
@@ -1181,36 +2779,446 @@ int Signal<ParamTypes...>::CountConnections(const Signal<ParamTypes...> &other)
 }
 
 template<typename ... ParamTypes>
-int Signal<ParamTypes...>::CountConnections() const {
-  int count = 0;
-  for (internal::InterRelatedDeque<internal::SignalTokenNode>::ConstIterator it = tokens_.cbegin();
-       it != tokens_.cend();
-       ++it) {
-    count++;
+void Signal<ParamTypes...>::Dispatch(typename internal::ArgRef<ParamTypes>::type ... Args) {
+  if (blocked_) return;
+
+  if (forward_count_ > 0) {
+    // The dispatch list cannot be rebuilt while it's being iterated
+    if (!IsDispatching() && ((nullptr == side_) || !side_->dispatch_valid)) CompileDispatch();
+    if (side_->dispatch_valid) {
+      DispatchFlat(Args...);
+      return;
+    }
   }
-  return count;
+
+  Slot slot(tokens_.begin(), emitting_);
+  emitting_ = &slot;
+
+  while (slot.it_ != tokens_.end()) {
+    if (!slot.it_->blocked) {
+      static_cast<internal::CallableToken<ParamTypes..., SLOT> * > (slot.it_.get())->Invoke(Args..., &slot);
+      if (slot.destroyed_) return;  // do not touch any member
+    }
+    ++slot;
+  }
+
+  emitting_ = slot.outer_;
 }
 
 template<typename ... ParamTypes>
-void Signal<ParamTypes...>::Emit(ParamTypes ... Args) {
-  Slot slot(&tokens_);
+void Signal<ParamTypes...>::EmitBatch(std::tuple<ParamTypes...> *tuples, size_t count) {
+  typedef internal::CallableToken<ParamTypes..., SLOT> TokenType;
+
+  if (blocked_) return;
 
-  while (slot.it_) {
-    slot.it_->slot_mark_head.push_back(&slot.mark_);
-    static_cast<internal::CallableToken<ParamTypes..., SLOT> * > (slot.it_.get())->Invoke(Args..., &slot);
+  Slot slot(tokens_.begin(), emitting_);
+  emitting_ = &slot;
+
+  while (slot.it_ != tokens_.end()) {
+    if (slot.it_->blocked) {
+      ++slot;
+      continue;
+    }
+
+    if (slot.it_->IsBatch()) {
+      static_cast<internal::BatchToken<ParamTypes...> *>(slot.it_.get())->InvokeBatch(tuples, count, &slot);
+      if (slot.destroyed_) return;
+    } else {
+      const TokenType *token = static_cast<TokenType *>(slot.it_.get());
+      for (size_t i = 0; i < count; i++) {
+        internal::InvokeWithTuple(token, tuples[i], &slot, std::index_sequence_for<ParamTypes...>());
+        if (slot.destroyed_) return;  // do not touch any member
+        if (slot.removed_) break;
+      }
+    }
     ++slot;
   }
+
+  emitting_ = slot.outer_;
 }
 
+/**
+ * @brief The state shared by the chunks of one EmitParallel()
+ */
 template<typename ... ParamTypes>
-void Signal<ParamTypes...>::DisconnectAll() {
-  internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin();
-  internal::InterRelatedNodeBase *tmp = nullptr;
+struct Signal<ParamTypes...>::ParallelEmission {
 
-  while (it != tokens_.end()) {
-    tmp = it.get();
+  template<size_t ... I>
+  void Invoke(internal::SignalTokenNode *token, SLOT slot, std::index_sequence<I...>) {
+    static_cast<internal::CallableToken<ParamTypes..., SLOT> *>(token)->Invoke(std::get<I>(args)..., slot);
+  }
+
+  const std::vector<internal::SignalTokenNode *> *list;
+
+  /**
+   * @brief The side table if list is its dispatch list, to skip the tokens
+   * removed by the emissions in progress
+   */
+  const internal::SignalSideTable *side;
+
+  std::tuple<typename internal::ArgRef<ParamTypes>::type...> args;
+
+  /**
+   * @brief Set for the positions whose slot method called UnbindSignal(),
+   * each position is written by the one thread running it
+   */
+  std::vector<char> unbound;
+
+};
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::EmitParallel(ThreadPool &pool, ParamTypes ... Args) {
+  static_assert(internal::NoMutableRef<ParamTypes...>::value,
+                "EmitParallel() shares the arguments between threads, non-const reference parameters are not allowed");
+
+  if (blocked_) return;
+
+  // Use the dispatch list unless it's out of date and being iterated by an
+  // emission in progress
+  std::vector<internal::SignalTokenNode *> local;
+  const std::vector<internal::SignalTokenNode *> *list = &local;
+  if (!IsDispatching()) {
+    if (!side_table()->dispatch_valid) CompileDispatch();
+    list = &side_->dispatch;
+  } else if (side_->dispatch_valid) {
+    list = &side_->dispatch;
+  } else {
+    CompileDispatch(this, &local);
+  }
+
+  ParallelEmission emission{list, list == &local ? nullptr : side_, std::forward_as_tuple(Args...),
+                            std::vector<char>(list->size(), 0)};
+  internal::ParallelEmit(pool, list->size(), &Signal::EmitRange, &emission);
+
+  std::vector<internal::SignalTokenNode *> unbound;
+  for (size_t i = 0; i < list->size(); i++) {
+    if (emission.unbound[i]) unbound.push_back((*list)[i]);
+  }
+
+  // A chained signal connected twice puts its tokens in the list twice
+  std::sort(unbound.begin(), unbound.end());
+  auto last = std::unique(unbound.begin(), unbound.end());
+  for (auto it = unbound.begin(); it != last; ++it) {
+    delete *it;
+  }
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::EmitRange(void *context, size_t begin, size_t end) {
+  auto *emission = static_cast<ParallelEmission *>(context);
+  const std::vector<internal::SignalTokenNode *> &list = *emission->list;
+
+  for (size_t i = begin; i < end; i++) {
+    if (((nullptr != emission->side) && emission->side->IsRemoved(list[i])) || list[i]->blocked) continue;
+
+    Slot slot(list[i]);
+    slot.deferred_ = true;
+    emission->Invoke(list[i], &slot, std::index_sequence_for<ParamTypes...>());
+
+    if (slot.unbind_) emission->unbound[i] = 1;
+  }
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::DispatchFlat(typename internal::ArgRef<ParamTypes>::type ... Args) {
+  typedef internal::CallableToken<ParamTypes..., SLOT> TokenType;
+
+  // The list is not changed until all emissions through it are finished,
+  // removed tokens are put in side_->removed
+  const std::vector<internal::SignalTokenNode *> &list = side_->dispatch;
+  Slot slot(static_cast<internal::SignalTokenNode *>(nullptr));
+  slot.outer_ = emitting_;
+  slot.flat_ = true;
+  emitting_ = &slot;
+  side_->dispatching++;
+
+  for (size_t i = 0; i < list.size(); i++) {
+    if (side_->IsRemoved(list[i]) || list[i]->blocked) continue;
+    slot.it_ = Slot::IteratorType(list[i]);
+    slot.removed_ = false;
+    static_cast<TokenType *>(list[i])->Invoke(Args..., &slot);
+    if (slot.destroyed_) return;  // do not touch any member
+  }
+
+  if (0 == --side_->dispatching) side_->removed.clear();
+  emitting_ = slot.outer_;
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::OnTokenRemoved(internal::SignalTokenNode *token) {
+  for (Slot *slot = emitting_; slot; slot = slot->outer_) {
+    if ((!slot->flat_) && (slot->it_.get() == token)) {
+      ++slot->it_;
+      slot->removed_ = true;
+    }
+  }
+
+  tokens_.erase(token);
+  if (nullptr != token->index_entry) Unindex(token);
+
+  if (token->IsForwarding()) forward_count_--;
+  InvalidateDispatch(token);
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::OnTokenBlocked(internal::SignalTokenNode *token) {
+  // Tokens of chained signals are in the dispatch list only if the
+  // forwarding token is not blocked
+  if (token->IsForwarding()) InvalidateDispatch(nullptr);
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::Block(bool blocked) {
+  if (blocked_ == blocked) return;
+
+  blocked_ = blocked;
+  InvalidateDispatch(nullptr);  // for signals forwarding to this one
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::OnTokenAdded(internal::SignalTokenNode *token) {
+  if ((nullptr != side_) && side_->IsIndexed()) {
+    internal::TokenIndexEntry *entry = IndexEntryOf(token);
+
+    if (!side_->positions.empty()) {
+      internal::InterRelatedNodeBase *previous = token->previous();
+      size_t position = 0;
+      if (!tokens_.is_end(previous)) {
+        position = internal::OrderStatisticTree::PositionOf(
+            static_cast<internal::SignalTokenNode *>(previous)->index_entry) + 1;
+      }
+      side_->positions.Insert(entry, position);
+    }
+
+    if (!side_->methods.empty()) {
+      side_->methods.Insert(entry, token->HashMethod());
+    }
+  }
+
+  if (token->IsForwarding()) forward_count_++;
+  InvalidateDispatch(nullptr);
+}
+
+template<typename ... ParamTypes>
+internal::SignalTokenNode *Signal<ParamTypes...>::TokenAt(size_t position) {
+  _ASSERT(position < tokens_.size());
+
+  if (tokens_.size() > kIndexThreshold) {
+    if ((nullptr == side_) || side_->positions.empty()) BuildPositionIndex();
+    return static_cast<internal::TokenIndexEntry *>(side_->positions.At(position))->token;
+  }
+
+  auto it = tokens_.begin();
+  while (position > 0) {
     ++it;
-    delete tmp;
+    position--;
+  }
+  return it.get();
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::BuildPositionIndex() {
+  internal::SignalSideTable *side = side_table();
+  _ASSERT(side->positions.empty());
+
+  size_t i = 0;
+  for (auto it = tokens_.begin(); it != tokens_.end(); ++it) {
+    side->positions.Insert(IndexEntryOf(it.get()), i++);
+  }
+}
+
+template<typename ... ParamTypes>
+bool Signal<ParamTypes...>::UseMethodIndex() const {
+  if ((nullptr != side_) && (!side_->methods.empty())) return true;
+  if (tokens_.size() <= kIndexThreshold) return false;
+
+  internal::SignalSideTable *side = const_cast<Signal *>(this)->side_table();
+  for (auto it = tokens_.begin(); it != tokens_.end(); ++it) {
+    side->methods.Insert(IndexEntryOf(it.get()), it->HashMethod());
+  }
+  return true;
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::Unindex(internal::SignalTokenNode *token) {
+  internal::TokenIndexEntry *entry = token->index_entry;
+
+  if (!side_->positions.empty()) side_->positions.Erase(entry);
+  if (!side_->methods.empty()) side_->methods.Erase(entry);
+
+  token->index_entry = nullptr;
+  delete entry;
+}
+
+template<typename ... ParamTypes>
+size_t Signal<ParamTypes...>::FindTokens(const void *object,
+                                         internal::GenericMethodPointer method,
+                                         std::vector<internal::SignalTokenNode *> *tokens) const {
+  size_t hash = internal::MethodIndex::Hash(object, method);
+  size_t count = 0;
+  internal::SignalTokenNode *token = nullptr;
+
+  for (internal::MethodIndexNode *node = side_->methods.Find(hash); node;
+       node = internal::MethodIndex::FindNext(node)) {
+    token = static_cast<internal::TokenIndexEntry *>(node)->token;
+    if (token->IsBoundTo(object, method)) {
+      count++;
+      if (tokens) tokens->push_back(token);
+    }
+  }
+  return count;
+}
+
+template<typename ... ParamTypes>
+int Signal<ParamTypes...>::DisconnectTokens(std::vector<internal::SignalTokenNode *> *tokens,
+                                            int start_pos,
+                                            int counts) {
+  if (tokens->empty()) return 0;
+  if (side_->positions.empty()) BuildPositionIndex();
+
+  std::vector<std::pair<size_t, internal::SignalTokenNode *>> found;
+  found.reserve(tokens->size());
+
+  for (internal::SignalTokenNode *token : *tokens) {
+    size_t position = internal::OrderStatisticTree::PositionOf(token->index_entry);
+    if (start_pos >= 0) {
+      if (position < static_cast<size_t>(start_pos)) continue;
+    } else {
+      size_t offset = static_cast<size_t>(-(start_pos + 1));
+      if (offset >= tokens_.size() || position > tokens_.size() - 1 - offset) continue;
+    }
+    found.push_back(std::make_pair(position, token));
+  }
+
+  if (start_pos >= 0) {
+    std::sort(found.begin(), found.end());
+  } else {
+    std::sort(found.rbegin(), found.rend());
+  }
+
+  int ret_count = 0;
+  for (auto &item : found) {
+    ret_count++;
+    counts--;
+    delete item.second;
+    if (counts == 0) break;
+  }
+
+  return ret_count;
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::InvalidateDispatch(const internal::SignalTokenNode *removed) {
+  if (invalidating_) return;  // signals are connected in a loop
+
+  invalidating_ = true;
+  if (nullptr != side_) side_->dispatch_valid = false;
+
+  if ((nullptr != removed) && IsDispatching()) {
+    side_->removed.insert(removed);  // O(1), the list is not scanned
+    for (Slot *slot = emitting_; slot; slot = slot->outer_) {
+      if (slot->flat_ && (slot->it_.get() == removed)) slot->removed_ = true;
+    }
+  }
+
+  // Signals forwarding to this one have SignalTokens bound to this object
+  for (auto it = bindings_.begin(); it != bindings_.end(); ++it) {
+    internal::SignalTokenNode *token = it.get()->token;
+    if (token->IsForwarding()) {
+      static_cast<Signal *>(token->trackable)->InvalidateDispatch(removed);
+    }
+  }
+
+  invalidating_ = false;
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::CompileDispatch() {
+  internal::SignalSideTable *side = side_table();
+
+  side->dispatch.clear();
+  CompileDispatch(this, &side->dispatch);
+  side->dispatch_valid = true;
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::CompileDispatch(Signal *signal, std::vector<internal::SignalTokenNode *> *list) {
+  for (auto it = signal->tokens_.begin(); it != signal->tokens_.end(); ++it) {
+    if (it->IsForwarding()) {
+      Signal *chained = static_cast<internal::SignalToken<ParamTypes...> *>(it.get())->signal();
+      if (it->blocked || chained->blocked_) continue;
+      CompileDispatch(chained, list);
+    } else {
+      list->push_back(it.get());
+    }
+  }
+}
+
+template<typename ... ParamTypes>
+template<typename TokenType, typename ArgType>
+void Signal<ParamTypes...>::NewConnection(ArgType &&arg,
+                                          internal::SignalTokenNode *&token,
+                                          internal::TrackableBindingNode *&binding,
+                                          std::true_type /* fits in a cell */) {
+  CellType *cell = FindFreeCell();
+  if (nullptr == cell) {
+    NewConnection<TokenType>(std::forward<ArgType>(arg), token, binding, std::false_type());
+    return;
+  }
+
+  typedef internal::InlineNode<TokenType> InlineTokenType;
+  typedef typename CellType::BindingType InlineBindingType;
+
+  token = new(&cell->token) InlineTokenType(&cell->token_in_use, std::forward<ArgType>(arg));
+  binding = new(&cell->binding) InlineBindingType(&cell->binding_in_use);
+}
+
+template<typename ... ParamTypes>
+template<typename TokenType, typename ArgType>
+void Signal<ParamTypes...>::NewConnection(ArgType &&arg,
+                                          internal::SignalTokenNode *&token,
+                                          internal::TrackableBindingNode *&binding,
+                                          std::false_type /* fits in a cell */) {
+  auto *record = internal::ConnectionRecord<TokenType>::New(std::forward<ArgType>(arg));
+  token = record->token();
+  binding = record->binding();
+}
+
+template<typename ... ParamTypes>
+void Signal<ParamTypes...>::DisconnectAll() {
+  if (nullptr != emitting_) {
+    // Emissions in progress must see each token removed
+    internal::InterRelatedDeque<internal::SignalTokenNode>::Iterator it = tokens_.begin();
+    internal::InterRelatedNodeBase *tmp = nullptr;
+
+    while (it != tokens_.end()) {
+      tmp = it.get();
+      ++it;
+      delete tmp;
+    }
+    return;
+  }
+
+  // Detach all tokens from this signal at once, so OnTokenRemoved() is not
+  // called for each one
+  internal::SignalTokenNode *token = tokens_.detach_all();
+  internal::SignalTokenNode *next = nullptr;
+  if (nullptr != side_) {
+    side_->positions.Clear();
+    side_->methods.Clear();
+    side_->dispatch_valid = false;
+  }
+  forward_count_ = 0;
+
+  while (token) {
+    next = static_cast<internal::SignalTokenNode *>(token->next());
+    // Signals forwarding to this one may be dispatching this token
+    if (!bindings_.empty()) InvalidateDispatch(token);
+    token->trackable = nullptr;
+    delete token->index_entry;
+    token->index_entry = nullptr;
+    delete token;
+    token = next;
   }
 }
 
@@ -1239,12 +3247,36 @@ class WIZTK_EXPORT SignalRef {
   ~SignalRef() = default;
 
   template<typename T>
-  void Connect(T *obj, void (T::*method)(ParamTypes..., SLOT), int index = -1) {
-    signal_->Connect(obj, method, index);
+  Connection Connect(T *obj, void (T::*method)(ParamTypes..., SLOT), int index = -1) {
+    return signal_->Connect(obj, method, index);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  Connection Connect(T *obj, void (T::*method)(SlotParamTypes...), int index = -1) {
+    return signal_->Connect(obj, method, index);
+  }
+
+  Connection Connect(Signal<ParamTypes...> &signal, int index = -1) {
+    return signal_->Connect(signal, index);
+  }
+
+  template<typename T>
+  Connection ConnectBatch(T *obj, void (T::*method)(std::tuple<ParamTypes...> *, size_t, SLOT), int index = -1) {
+    return signal_->ConnectBatch(obj, method, index);
   }
 
-  void Connect(Signal<ParamTypes...> &signal, int index = -1) {
-    signal_->Connect(signal, index);
+  template<typename T, typename ... SlotParamTypes>
+  Connection Connect(T *obj, void (T::*method)(SlotParamTypes...), Executor &executor, int index = -1) {
+    return signal_->Connect(obj, method, executor, index);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  Connection ConnectCoalesced(T *obj,
+                              void (T::*method)(SlotParamTypes...),
+                              Executor &executor,
+                              typename Signal<ParamTypes...>::MergeFunction merge = nullptr,
+                              int index = -1) {
+    return signal_->ConnectCoalesced(obj, method, executor, merge, index);
   }
 
   template<typename T>
@@ -1252,6 +3284,11 @@ class WIZTK_EXPORT SignalRef {
     signal_->DisconnectAll(obj, method);
   }
 
+  template<typename T, typename ... SlotParamTypes>
+  void DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...)) {
+    signal_->DisconnectAll(obj, method);
+  }
+
   void DisconnectAll(Signal<ParamTypes...> &signal) {
     signal_->DisconnectAll(signal);
   }
@@ -1261,6 +3298,11 @@ class WIZTK_EXPORT SignalRef {
     return signal_->Disconnect(obj, method, start_pos, counts);
   }
 
+  template<typename T, typename ... SlotParamTypes>
+  int Disconnect(T *obj, void (T::*method)(SlotParamTypes...), int start_pos = -1, int counts = 1) {
+    return signal_->Disconnect(obj, method, start_pos, counts);
+  }
+
   int Disconnect(Signal<ParamTypes...> &signal, int start_pos = -1, int counts = 1) {
     return signal_->Disconnect(signal, start_pos, counts);
   }
@@ -1278,6 +3320,11 @@ class WIZTK_EXPORT SignalRef {
     return signal_->IsConnectedTo(obj, method);
   }
 
+  template<typename T, typename ... SlotParamTypes>
+  bool IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const {
+    return signal_->IsConnectedTo(obj, method);
+  }
+
   bool IsConnectedTo(const Signal<ParamTypes...> &signal) const {
     return signal_->IsConnectedTo(signal);
   }
@@ -1291,6 +3338,11 @@ class WIZTK_EXPORT SignalRef {
     return signal_->CountConnections(obj, method);
   }
 
+  template<typename T, typename ... SlotParamTypes>
+  int CountConnections(T *obj, void (T::*method)(SlotParamTypes...)) const {
+    return signal_->CountConnections(obj, method);
+  }
+
   int CountConnections(const Signal<ParamTypes...> &signal) const {
     return signal_->CountConnections(signal);
   }
@@ -1299,6 +3351,10 @@ class WIZTK_EXPORT SignalRef {
     return signal_->CountConnections();
   }
 
+  bool empty() const {
+    return signal_->empty();
+  }
+
   size_t CountBindings() const {
     return signal_->CountSignalBindings();
   }
@@ -0,0 +1,94 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/**
+ * @file static_signal.hpp
+ * @brief Header file for StaticSignal class.
+ */
+
+#ifndef WIZTK_BASE_STATIC_SIGNAL_HPP_
+#define WIZTK_BASE_STATIC_SIGNAL_HPP_
+
+#include "sigcxx/sigcxx.hpp"
+
+namespace sigcxx {
+
+/**
+ * @ingroup base
+ * @brief A signal with a fixed number of connections stored inline
+ * @tparam N The maximum number of connections
+ * @tparam ParamTypes
+ *
+ * StaticSignal is a Signal which creates the token and binding of up to N
+ * connections in the memory of the signal object itself, connecting and
+ * disconnecting never allocate. Connections still behave the same as in
+ * Signal: they are removed automatically when the observer or the signal is
+ * destroyed, and can be broken in slot methods.
+ *
+ * Connecting more than N times is an error and asserts in debug build, in
+ * release build the extra connections are allocated on the heap. Batch,
+ * queued and coalesced connections do not fit in a cell, they are always
+ * allocated and do not count.
+ */
+template<size_t N, typename ... ParamTypes>
+class WIZTK_EXPORT StaticSignal : public Signal<ParamTypes...> {
+
+  static_assert(N > 0, "A StaticSignal must have at least one connection");
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(StaticSignal);
+
+  StaticSignal() = default;
+
+  /**
+   * @brief Destructor
+   *
+   * Disconnect all here as the cells are destroyed before ~Signal().
+   */
+  ~StaticSignal() final {
+    this->DisconnectAll();
+  }
+
+  /**
+   * @brief The maximum number of connections
+   */
+  static constexpr size_t capacity() {
+    return N;
+  }
+
+ protected:
+
+  typedef typename Signal<ParamTypes...>::CellType CellType;
+
+  CellType *FindFreeCell() final {
+    for (size_t i = 0; i < N; i++) {
+      if (cells_[i].IsFree()) return &cells_[i];
+    }
+
+    _ASSERT(false);  // no more room
+    return nullptr;
+  }
+
+ private:
+
+  CellType cells_[N];
+
+};
+
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_STATIC_SIGNAL_HPP_
@@ -0,0 +1,101 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file thread_pool.hpp
+ * @brief Header file for ThreadPool class.
+ */
+
+#ifndef WIZTK_BASE_THREAD_POOL_HPP_
+#define WIZTK_BASE_THREAD_POOL_HPP_
+
+#include "sigcxx/macros.hpp"
+
+#include <cstddef>
+
+namespace sigcxx {
+
+namespace internal {
+struct ThreadPoolState;
+}
+
+/**
+ * @ingroup base
+ * @brief A work-stealing thread pool for parallel loops
+ *
+ * Each worker thread has a deque of ranges. A thread running a range larger
+ * than the grain splits it in halves, pushes the upper half to the back of
+ * its own deque and goes on with the lower half. Idle workers steal from the
+ * front of other deques, which holds the largest ranges.
+ *
+ * The thread calling ParallelFor() runs ranges as well until the whole loop
+ * is done, so ParallelFor() can be called in a range function.
+ *
+ * @see Signal::EmitParallel()
+ */
+class WIZTK_EXPORT ThreadPool {
+
+ public:
+
+  /**
+   * @brief The function to run for the indices in [begin, end)
+   */
+  typedef void (*RangeFunction)(void *context, size_t begin, size_t end);
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(ThreadPool);
+
+  /**
+   * @brief Create a pool with one worker less than the hardware threads, the
+   * thread calling ParallelFor() is the last one
+   */
+  ThreadPool();
+
+  /**
+   * @brief Create a pool with the given number of worker threads
+   *
+   * With 0 worker threads ParallelFor() runs everything in the calling thread.
+   */
+  explicit ThreadPool(size_t num_threads);
+
+  /**
+   * @brief Destructor, must not be called while a ParallelFor() is running
+   */
+  ~ThreadPool();
+
+  /**
+   * @brief Run the function for all indices in [0, count) and wait until it's done
+   * @param count The number of indices
+   * @param grain The largest range run by one call of the function
+   * @param function The function to run in the worker threads and this thread
+   * @param context Passed to the function
+   */
+  void ParallelFor(size_t count, size_t grain, RangeFunction function, void *context);
+
+  /**
+   * @brief Returns the number of worker threads
+   */
+  size_t CountThreads() const;
+
+ private:
+
+  internal::ThreadPoolState *state_;
+
+};
+
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_THREAD_POOL_HPP_
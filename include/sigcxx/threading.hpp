@@ -0,0 +1,929 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file threading.hpp
+ * @brief Threading policies, BasicTrackable and BasicSignal.
+ */
+
+#ifndef WIZTK_BASE_THREADING_HPP_
+#define WIZTK_BASE_THREADING_HPP_
+
+#include "sigcxx/sigcxx.hpp"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace sigcxx {
+
+/**
+ * @ingroup base
+ * @brief The threading policy of Trackable and Signal, no locking at all
+ *
+ * BasicTrackable<SingleThreaded> is Trackable and BasicSignal<SingleThreaded,
+ * ParamTypes...> is Signal<ParamTypes...>, the same classes and code.
+ */
+struct WIZTK_EXPORT SingleThreaded {
+  void lock() {}
+  void unlock() {}
+  bool try_lock() { return true; }
+};
+
+/**
+ * @ingroup base
+ * @brief The threading policy of a spin lock in each object
+ *
+ * Use this for objects which are rarely connected or disconnected at the same
+ * time in different threads.
+ */
+class WIZTK_EXPORT SpinLock {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(SpinLock);
+
+  SpinLock() = default;
+
+  void lock() {
+    while (flag_.test_and_set(std::memory_order_acquire)) {
+      std::this_thread::yield();
+    }
+  }
+
+  void unlock() {
+    flag_.clear(std::memory_order_release);
+  }
+
+  bool try_lock() {
+    return !flag_.test_and_set(std::memory_order_acquire);
+  }
+
+ private:
+
+  std::atomic_flag flag_ = ATOMIC_FLAG_INIT;
+
+};
+
+/**
+ * @ingroup base
+ * @brief The threading policy of a std::mutex in each object
+ */
+class WIZTK_EXPORT MutexLock {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(MutexLock);
+
+  MutexLock() = default;
+
+  void lock() {
+    mutex_.lock();
+  }
+
+  void unlock() {
+    mutex_.unlock();
+  }
+
+  bool try_lock() {
+    return mutex_.try_lock();
+  }
+
+ private:
+
+  std::mutex mutex_;
+
+};
+
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief The lock of a Trackable, the policy type is erased so a signal can
+ * lock any observer
+ */
+class WIZTK_NO_EXPORT Lockable {
+
+ public:
+
+  virtual ~Lockable() = default;
+
+  virtual void lock() = 0;
+
+  virtual void unlock() = 0;
+
+  virtual bool try_lock() = 0;
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief A Lockable using a threading policy
+ *
+ * The lock is recursive: a LockedSignal holds its lock while emitting, and
+ * slot methods called in the same thread can still change its connections.
+ */
+template<typename Policy>
+class WIZTK_NO_EXPORT PolicyLock final : public Lockable {
+
+ public:
+
+  void lock() final {
+    if (owner_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+      depth_++;
+      return;
+    }
+    policy_.lock();
+    owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    depth_ = 1;
+  }
+
+  void unlock() final {
+    if (--depth_ > 0) return;
+    owner_.store(std::thread::id(), std::memory_order_relaxed);
+    policy_.unlock();
+  }
+
+  bool try_lock() final {
+    if (owner_.load(std::memory_order_relaxed) == std::this_thread::get_id()) {
+      depth_++;
+      return true;
+    }
+    if (!policy_.try_lock()) return false;
+    owner_.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    depth_ = 1;
+    return true;
+  }
+
+ private:
+
+  Policy policy_;
+
+  std::atomic<std::thread::id> owner_{std::thread::id()};
+
+  unsigned depth_ = 0;  // guarded by policy_
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief Lock the signal and the observer of connections
+ *
+ * A connection is changed with the locks of both ends held. A thread waits
+ * only for the first lock of a step, the lock of the other end is only
+ * tried, and on failure the first one is released and the whole step is
+ * done again. The only locks held while waiting are those of the
+ * LockedSignals being emitted in the thread, which are recursive.
+ *
+ * A nullptr lock is a single-threaded object and never locked.
+ */
+struct WIZTK_NO_EXPORT TrackableLocking {
+
+  static Lockable *LockOf(const Trackable *trackable) {
+    return trackable->GetLock();
+  }
+
+  /**
+   * @brief Try to lock a second lock while holding the first one
+   * @return false if the second lock is busy and the caller has to back off
+   */
+  static bool TryLockAfter(Lockable *held, Lockable *second) {
+    if (nullptr == second || second == held) return true;
+    return second->try_lock();
+  }
+
+  static void UnlockAfter(Lockable *held, Lockable *second) {
+    if (nullptr != second && second != held) second->unlock();
+  }
+
+  /**
+   * @brief Repeatedly find a binding of the trackable with its own lock held
+   * and delete it with the lock of the signal held as well
+   * @param find Returns the binding to be deleted, or nullptr to stop
+   */
+  template<typename FindFunction>
+  static void Unbind(Trackable *trackable, FindFunction find) {
+    Lockable *lock = LockOf(trackable);
+
+    while (true) {
+      lock->lock();
+
+      TrackableBindingNode *binding = find();
+      if (nullptr == binding) {
+        lock->unlock();
+        return;
+      }
+
+      Lockable *signal_lock = LockOf(binding->token->trackable);
+      if (TryLockAfter(lock, signal_lock)) {
+        delete binding;
+        UnlockAfter(lock, signal_lock);
+        lock->unlock();
+      } else {
+        lock->unlock();
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  static void UnbindAll(Trackable *trackable) {
+    Unbind(trackable, [trackable]() -> TrackableBindingNode * {
+      if (trackable->bindings_.empty()) return nullptr;
+      return trackable->bindings_.rbegin().get();
+    });
+  }
+
+  template<typename T, typename ... ParamTypes>
+  static void UnbindAllTo(Trackable *trackable, void (T::*method)(ParamTypes...)) {
+    const void *object = (T *) trackable;
+    auto generic_method = reinterpret_cast<GenericMethodPointer>(method);
+
+    Unbind(trackable, [trackable, object, generic_method]() -> TrackableBindingNode * {
+      for (auto it = trackable->bindings_.rbegin(); it != trackable->bindings_.rend(); ++it) {
+        if (it.get()->token->IsBoundTo(object, generic_method)) return it.get();
+      }
+      return nullptr;
+    });
+  }
+
+  static void UnbindSlot(Trackable *trackable, SLOT slot) {
+    if (slot->deferred_) {
+      trackable->UnbindSignal(slot);
+      return;
+    }
+    Unbind(trackable, [trackable, slot]() -> TrackableBindingNode * {
+      if (slot->removed_ || slot->it_.get()->binding->trackable != trackable) return nullptr;
+      return slot->it_.get()->binding;
+    });
+  }
+
+  static size_t CountBindings(const Trackable *trackable) {
+    std::lock_guard<Lockable> guard(*LockOf(trackable));
+    return trackable->bindings_.size();
+  }
+
+  /**
+   * @brief Delete the token of a Connection to a locked signal with the
+   * locks of both ends held
+   * @param signal_lock The lock of the signal
+   * @param token The token pointer in the Connection, cleared under the lock
+   * of the signal by whoever deletes the token
+   */
+  static void DisconnectToken(Lockable *signal_lock, SignalTokenNode *const *token) {
+    while (true) {
+      signal_lock->lock();
+
+      if (nullptr == *token) {
+        signal_lock->unlock();
+        return;
+      }
+
+      Lockable *observer_lock = LockOf((*token)->binding->trackable);
+      if (TryLockAfter(signal_lock, observer_lock)) {
+        delete *token;
+        UnlockAfter(signal_lock, observer_lock);
+        signal_lock->unlock();
+        return;
+      }
+
+      signal_lock->unlock();
+      std::this_thread::yield();
+    }
+  }
+
+};
+
+/**
+ * @ingroup base_intern
+ * @brief Hold the locks of a signal and an observer known beforehand
+ */
+class WIZTK_NO_EXPORT PairLock {
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(PairLock);
+  PairLock() = delete;
+
+  PairLock(Lockable *signal_lock, Lockable *observer_lock)
+      : first_(signal_lock), second_(observer_lock) {
+    while (true) {
+      first_->lock();
+      if (TrackableLocking::TryLockAfter(first_, second_)) break;
+      first_->unlock();
+      std::this_thread::yield();
+    }
+  }
+
+  ~PairLock() {
+    TrackableLocking::UnlockAfter(first_, second_);
+    first_->unlock();
+  }
+
+ private:
+
+  Lockable *first_;
+  Lockable *second_;
+
+};
+
+}  // namespace internal
+
+/**
+ * @ingroup base
+ * @brief A Trackable which can be connected, disconnected and destroyed in
+ * different threads
+ * @tparam Policy SpinLock or MutexLock
+ *
+ * Use BasicTrackable<Policy> as the base class of an observer. The bindings
+ * are guarded by a lock in this object, every connection is changed with the
+ * locks of both the observer and the signal held, see
+ * internal::TrackableLocking for the lock order.
+ *
+ * Destroying the observer waits until no LockedSignal is calling it in
+ * another thread. The wait is in the destructor of this class, after the
+ * members of a derived observer are gone: call UnbindAllSignals() first in
+ * the destructor of an observer whose slot methods use its members.
+ *
+ * Only connections between locked objects are guarded: a plain Signal on the
+ * other end, or the methods of Trackable called on this object through a
+ * Trackable pointer, do not lock anything.
+ */
+template<typename Policy>
+class WIZTK_EXPORT LockedTrackable : public Trackable {
+
+ public:
+
+  LockedTrackable() = default;
+
+  /**
+   * @brief Copy constructor
+   *
+   * Do nothing in copy constructor.
+   */
+  LockedTrackable(const LockedTrackable &)
+      : LockedTrackable() {}
+
+  ~LockedTrackable() override {
+    internal::TrackableLocking::UnbindAll(this);
+  }
+
+  /**
+   * @brief Copy assignment
+   *
+   * Do nothing in copy assignment.
+   */
+  LockedTrackable &operator=(const LockedTrackable &) {
+    return *this;
+  }
+
+  template<typename T, typename ... ParamTypes>
+  size_t CountSignalBindings(void (T::*method)(ParamTypes...)) const {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    return Trackable::CountSignalBindings(method);
+  }
+
+  size_t CountSignalBindings() const {
+    return internal::TrackableLocking::CountBindings(this);
+  }
+
+ protected:
+
+  void UnbindSignal(SLOT slot) {
+    internal::TrackableLocking::UnbindSlot(this, slot);
+  }
+
+  void UnbindAllSignals() {
+    internal::TrackableLocking::UnbindAll(this);
+  }
+
+  template<typename T, typename ... ParamTypes>
+  void UnbindAllSignalsTo(void (T::*method)(ParamTypes...)) {
+    internal::TrackableLocking::UnbindAllTo(this, method);
+  }
+
+ private:
+
+  internal::Lockable *GetLock() const final {
+    return &policy_lock_;
+  }
+
+  mutable internal::PolicyLock<Policy> policy_lock_;
+
+};
+
+/**
+ * @ingroup base
+ * @brief The handle to one connection returned by LockedSignal::Connect()
+ *
+ * Works like a Connection, but keeps the lock of the signal: moving,
+ * resetting and blocking take it, and Disconnect() takes the locks of both
+ * ends, so the connection can be removed in another thread at the same time.
+ * The handle itself is not locked, it must not be used in two threads at
+ * once, and the signal must outlive these calls. Destroying the signal
+ * clears the lock of its remaining handles.
+ *
+ * A plain Signal returns a Connection, which never looks up a lock.
+ */
+class WIZTK_EXPORT LockedConnection : private Connection {
+
+  template<typename Policy, typename ... ParamTypes> friend
+  class LockedSignal;
+
+ public:
+
+  LockedConnection() = default;
+
+  LockedConnection(const LockedConnection &) = delete;
+
+  LockedConnection(LockedConnection &&other) noexcept {
+    Take(&other);
+  }
+
+  ~LockedConnection() {
+    Reset();
+  }
+
+  LockedConnection &operator=(const LockedConnection &) = delete;
+
+  LockedConnection &operator=(LockedConnection &&other) noexcept {
+    if (this != &other) {
+      Reset();
+      Take(&other);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Break the connection with the locks of both ends held
+   */
+  void Disconnect() {
+    internal::Lockable *lock = lock_.load(std::memory_order_acquire);
+    if (nullptr != lock) {
+      internal::TrackableLocking::DisconnectToken(lock, &token_);
+    }
+  }
+
+  /**
+   * @brief Forget the connection without breaking it
+   */
+  void Reset() {
+    internal::Lockable *lock = lock_.load(std::memory_order_acquire);
+    if (nullptr == lock) return;
+
+    std::lock_guard<internal::Lockable> guard(*lock);
+    Connection::Reset();
+    lock_.store(nullptr, std::memory_order_relaxed);
+  }
+
+  using Connection::IsConnected;
+
+  using Connection::operator bool;
+
+  /**
+   * @brief Block or unblock the connection with the lock of the signal held
+   */
+  void Block(bool blocked = true) {
+    internal::Lockable *lock = lock_.load(std::memory_order_acquire);
+    if (nullptr == lock) return;
+
+    std::lock_guard<internal::Lockable> guard(*lock);
+    Connection::Block(blocked);
+  }
+
+  void Unblock() {
+    Block(false);
+  }
+
+  using Connection::IsBlocked;
+
+ private:
+
+  LockedConnection(Connection &&connection, internal::Lockable *lock) noexcept
+      : Connection(std::move(connection)),
+        lock_(nullptr == token_ ? nullptr : lock) {}
+
+  /**
+   * @brief Move the token from another handle with the lock of the signal
+   * held
+   */
+  void Take(LockedConnection *other) {
+    internal::Lockable *lock = other->lock_.load(std::memory_order_acquire);
+    if (nullptr == lock) return;
+
+    std::lock_guard<internal::Lockable> guard(*lock);
+    Connection::operator=(std::move(*other));
+    other->lock_.store(nullptr, std::memory_order_relaxed);
+    if (nullptr != token_) lock_.store(lock, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Called by the destructor of the signal, with its lock held, for
+   * each token which still has a handle
+   */
+  static void ForgetLock(Connection *connection) {
+    static_cast<LockedConnection *>(connection)->lock_.store(nullptr, std::memory_order_release);
+  }
+
+  /**
+   * @brief The lock of the signal guarding token_, nullptr once the handle
+   * is empty or the signal is gone
+   */
+  std::atomic<internal::Lockable *> lock_{nullptr};
+
+};
+
+/**
+ * @ingroup base
+ * @brief A LockedConnection which breaks the connection when destroyed
+ */
+class WIZTK_EXPORT ScopedLockedConnection : public LockedConnection {
+
+ public:
+
+  ScopedLockedConnection() = default;
+
+  ScopedLockedConnection(LockedConnection &&other) noexcept
+      : LockedConnection(std::move(other)) {}
+
+  ScopedLockedConnection(ScopedLockedConnection &&other) noexcept = default;
+
+  ~ScopedLockedConnection() {
+    Disconnect();
+  }
+
+  ScopedLockedConnection &operator=(LockedConnection &&other) noexcept {
+    Disconnect();
+    LockedConnection::operator=(std::move(other));
+    return *this;
+  }
+
+  ScopedLockedConnection &operator=(ScopedLockedConnection &&other) noexcept {
+    return operator=(static_cast<LockedConnection &&>(other));
+  }
+
+  /**
+   * @brief Give up the ownership and return the LockedConnection
+   */
+  LockedConnection Release() {
+    return LockedConnection(std::move(*this));
+  }
+
+};
+
+/**
+ * @ingroup base
+ * @brief A Signal which can be emitted, connected, disconnected and
+ * destroyed in different threads
+ * @tparam Policy SpinLock or MutexLock
+ * @tparam ParamTypes
+ *
+ * Every method takes the lock of this signal, and the methods changing a
+ * connection take the lock of the observer as well. Methods which remove
+ * connections to different observers, like DisconnectAll(), remove one
+ * connection at a time. As an observer of chained signals this works as a
+ * LockedTrackable, and the same rules apply.
+ *
+ * Emit() holds the lock while calling the slot methods, so removing a
+ * connection or destroying an observer in another thread waits until the
+ * emission has returned. The lock is recursive, slot methods can change the
+ * connections of this signal. A slot method must not destroy this signal,
+ * and must not wait for another thread changing its connections or emitting
+ * a signal which in turn changes or emits this one.
+ *
+ * The signal is not a Signal for the users: it privately derives from it so
+ * that the methods which take no lock cannot be reached through a Signal
+ * reference, a SignalRef or a Trackable pointer, and Slot::signal() returns
+ * nullptr. It can only be chained to another LockedSignal of the same type,
+ * and EmitParallel() is not available.
+ *
+ * Connect() returns a LockedConnection, which takes the lock of this signal
+ * when it's used.
+ */
+template<typename Policy, typename ... ParamTypes>
+class WIZTK_EXPORT LockedSignal : private Signal<ParamTypes...> {
+
+  friend class Signal<ParamTypes...>;
+
+ public:
+
+  typedef Signal<ParamTypes...> SignalType;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(LockedSignal);
+
+  LockedSignal() = default;
+
+  ~LockedSignal() override {
+    ForgetConnections();
+    DisconnectAll();
+    internal::TrackableLocking::UnbindAll(this);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  LockedConnection Connect(T *obj, void (T::*method)(SlotParamTypes...), int index = -1) {
+    internal::PairLock guard(&policy_lock_, internal::TrackableLocking::LockOf(obj));
+    return LockedConnection(SignalType::Connect(obj, method, index), &policy_lock_);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  LockedConnection Connect(T *obj, void (T::*method)(SlotParamTypes...), Executor &executor, int index = -1) {
+    internal::PairLock guard(&policy_lock_, internal::TrackableLocking::LockOf(obj));
+    return LockedConnection(SignalType::Connect(obj, method, executor, index), &policy_lock_);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  LockedConnection ConnectCoalesced(T *obj,
+                                    void (T::*method)(SlotParamTypes...),
+                                    Executor &executor,
+                                    typename SignalType::MergeFunction merge = nullptr,
+                                    int index = -1) {
+    internal::PairLock guard(&policy_lock_, internal::TrackableLocking::LockOf(obj));
+    return LockedConnection(SignalType::ConnectCoalesced(obj, method, executor, merge, index), &policy_lock_);
+  }
+
+  /**
+   * @brief Chain another locked signal, emitting this one emits it with its
+   * own lock held
+   */
+  LockedConnection Connect(LockedSignal &other, int index = -1) {
+    internal::PairLock guard(&policy_lock_, &other.policy_lock_);
+    return LockedConnection(SignalType::Connect(&other, &LockedSignal::Forward, index), &policy_lock_);
+  }
+
+  template<typename T>
+  LockedConnection ConnectBatch(T *obj, void (T::*method)(std::tuple<ParamTypes...> *, size_t, SLOT), int index = -1) {
+    internal::PairLock guard(&policy_lock_, internal::TrackableLocking::LockOf(obj));
+    return LockedConnection(SignalType::ConnectBatch(obj, method, index), &policy_lock_);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  void DisconnectAll(T *obj, void (T::*method)(SlotParamTypes...)) {
+    internal::PairLock guard(&policy_lock_, internal::TrackableLocking::LockOf(obj));
+    SignalType::DisconnectAll(obj, method);
+  }
+
+  void DisconnectAll(LockedSignal &other) {
+    DisconnectAll(&other, &LockedSignal::Forward);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  int Disconnect(T *obj, void (T::*method)(SlotParamTypes...), int start_pos = -1, int counts = 1) {
+    internal::PairLock guard(&policy_lock_, internal::TrackableLocking::LockOf(obj));
+    return SignalType::Disconnect(obj, method, start_pos, counts);
+  }
+
+  int Disconnect(LockedSignal &other, int start_pos = -1, int counts = 1) {
+    return Disconnect(&other, &LockedSignal::Forward, start_pos, counts);
+  }
+
+  /**
+   * @brief Disconnect any kind of connections from the start position
+   *
+   * The same as Signal::Disconnect(int, int), except that the connections
+   * are removed one by one.
+   */
+  int Disconnect(int start_pos = -1, int counts = 1) {
+    int ret_count = 0;
+    while ((counts <= 0 || ret_count < counts) && DisconnectAt(start_pos)) {
+      ret_count++;
+    }
+    return ret_count;
+  }
+
+  void DisconnectAll() {
+    while (DisconnectAt(-1)) {}
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  bool IsConnectedTo(T *obj, void (T::*method)(SlotParamTypes...)) const {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    return SignalType::IsConnectedTo(obj, method);
+  }
+
+  bool IsConnectedTo(const LockedSignal &other) const {
+    return IsConnectedTo(const_cast<LockedSignal *>(&other), &LockedSignal::Forward);
+  }
+
+  bool IsConnectedTo(const Trackable *obj) const {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    return SignalType::IsConnectedTo(obj);
+  }
+
+  template<typename T, typename ... SlotParamTypes>
+  int CountConnections(T *obj, void (T::*method)(SlotParamTypes...)) const {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    return SignalType::CountConnections(obj, method);
+  }
+
+  int CountConnections(const LockedSignal &other) const {
+    return CountConnections(const_cast<LockedSignal *>(&other), &LockedSignal::Forward);
+  }
+
+  int CountConnections() const {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    return SignalType::CountConnections();
+  }
+
+  bool empty() const {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    return SignalType::empty();
+  }
+
+  size_t CountSignalBindings() const {
+    return internal::TrackableLocking::CountBindings(this);
+  }
+
+  /**
+   * @brief Emit this signal with the lock held
+   */
+  void Emit(ParamTypes ... Args) {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    SignalType::Forward(Args..., nullptr);
+  }
+
+  void operator()(ParamTypes ... Args) {
+    Emit(std::forward<ParamTypes>(Args)...);
+  }
+
+  void EmitBatch(std::tuple<ParamTypes...> *tuples, size_t count) {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    SignalType::EmitBatch(tuples, count);
+  }
+
+  void Block(bool blocked = true) {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    SignalType::Block(blocked);
+  }
+
+  void Unblock() {
+    Block(false);
+  }
+
+  bool IsBlocked() const {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    return SignalType::IsBlocked();
+  }
+
+ private:
+
+  /**
+   * @brief The slot method connected by a chaining signal
+   */
+  void Forward(typename internal::ArgRef<ParamTypes>::type ... Args, SLOT /* slot */) {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    SignalType::Forward(Args..., nullptr);
+  }
+
+  /**
+   * @brief Remove the connection at the position with the lock of its
+   * observer held
+   * @return false if there's no connection at the position
+   */
+  bool DisconnectAt(int start_pos);
+
+  /**
+   * @brief Clear the lock of the handles which may outlive this signal
+   */
+  void ForgetConnections() {
+    std::lock_guard<internal::Lockable> guard(policy_lock_);
+    for (auto it = this->tokens_.begin(); it != this->tokens_.end(); ++it) {
+      if (nullptr != it->connection) LockedConnection::ForgetLock(it->connection);
+    }
+  }
+
+  internal::Lockable *GetLock() const final {
+    return &policy_lock_;
+  }
+
+  const void *GetSignalTypeTag() const final {
+    return nullptr;
+  }
+
+  mutable internal::PolicyLock<Policy> policy_lock_;
+
+};
+
+template<typename Policy, typename ... ParamTypes>
+bool LockedSignal<Policy, ParamTypes...>::DisconnectAt(int start_pos) {
+  internal::SignalTokenNode *token = nullptr;
+  internal::Lockable *observer_lock = nullptr;
+
+  while (true) {
+    policy_lock_.lock();
+
+    if (start_pos >= 0) {
+      auto it = this->IteratorAt(start_pos);
+      token = (it == this->tokens_.end()) ? nullptr : it.get();
+    } else {
+      auto it = this->ReverseIteratorAt(start_pos);
+      token = (it == this->tokens_.rend()) ? nullptr : it.get();
+    }
+
+    if (nullptr == token) {
+      policy_lock_.unlock();
+      return false;
+    }
+
+    observer_lock = internal::TrackableLocking::LockOf(token->binding->trackable);
+    if (internal::TrackableLocking::TryLockAfter(&policy_lock_, observer_lock)) {
+      delete token;
+      internal::TrackableLocking::UnlockAfter(&policy_lock_, observer_lock);
+      policy_lock_.unlock();
+      return true;
+    }
+
+    policy_lock_.unlock();
+    std::this_thread::yield();
+  }
+}
+
+namespace internal {
+
+template<typename Policy>
+struct TrackableOf {
+  typedef LockedTrackable<Policy> type;
+};
+
+template<>
+struct TrackableOf<SingleThreaded> {
+  typedef Trackable type;
+};
+
+template<typename Policy, typename ... ParamTypes>
+struct SignalOf {
+  typedef LockedSignal<Policy, ParamTypes...> type;
+};
+
+template<typename ... ParamTypes>
+struct SignalOf<SingleThreaded, ParamTypes...> {
+  typedef Signal<ParamTypes...> type;
+};
+
+template<typename Policy>
+struct ConnectionOf {
+  typedef LockedConnection type;
+  typedef ScopedLockedConnection scoped_type;
+};
+
+template<>
+struct ConnectionOf<SingleThreaded> {
+  typedef Connection type;
+  typedef ScopedConnection scoped_type;
+};
+
+}  // namespace internal
+
+/**
+ * @ingroup base
+ * @brief The base class of an observer with a threading policy
+ *
+ * SingleThreaded selects Trackable itself, SpinLock or MutexLock selects
+ * LockedTrackable.
+ */
+template<typename Policy>
+using BasicTrackable = typename internal::TrackableOf<Policy>::type;
+
+/**
+ * @ingroup base
+ * @brief A signal with a threading policy
+ *
+ * SingleThreaded selects Signal itself, SpinLock or MutexLock selects
+ * LockedSignal.
+ */
+template<typename Policy, typename ... ParamTypes>
+using BasicSignal = typename internal::SignalOf<Policy, ParamTypes...>::type;
+
+/**
+ * @ingroup base
+ * @brief The connection handle returned by BasicSignal<Policy, ...>::Connect()
+ *
+ * SingleThreaded selects Connection, SpinLock or MutexLock selects
+ * LockedConnection.
+ */
+template<typename Policy>
+using BasicConnection = typename internal::ConnectionOf<Policy>::type;
+
+/**
+ * @ingroup base
+ * @brief ScopedConnection or ScopedLockedConnection by threading policy
+ */
+template<typename Policy>
+using BasicScopedConnection = typename internal::ConnectionOf<Policy>::scoped_type;
+
+} // namespace sigcxx
+
+#endif // WIZTK_BASE_THREADING_HPP_
@@ -0,0 +1,263 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+/**
+ * @file timer_wheel.hpp
+ * @brief Header file for Timer and TimerWheel classes.
+ */
+
+#ifndef WIZTK_BASE_TIMER_WHEEL_HPP_
+#define WIZTK_BASE_TIMER_WHEEL_HPP_
+
+#include "sigcxx/sigcxx.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace sigcxx {
+
+class Timer;
+class TimerWheel;
+
+namespace internal {
+
+/**
+ * @ingroup base_intern
+ * @brief A node in the circular list of a wheel slot, the slot itself is a
+ * node linked to itself when empty
+ */
+struct WIZTK_NO_EXPORT TimerNode {
+
+  TimerNode()
+      : previous(this), next(this) {}
+
+  bool empty() const {
+    return next == this;
+  }
+
+  void PushBack(TimerNode *node) {
+    node->previous = previous;
+    node->next = this;
+    previous->next = node;
+    previous = node;
+  }
+
+  void Unlink() {
+    previous->next = next;
+    next->previous = previous;
+    previous = this;
+    next = this;
+  }
+
+  /**
+   * @brief Move all nodes of the list to the end of another one
+   */
+  void MoveTo(TimerNode *list) {
+    if (empty()) return;
+    next->previous = list->previous;
+    previous->next = list;
+    list->previous->next = next;
+    list->previous = previous;
+    previous = this;
+    next = this;
+  }
+
+  TimerNode *previous;
+  TimerNode *next;
+
+};
+
+} // namespace internal
+
+/**
+ * @ingroup base
+ * @brief A one-shot timer which emits timeout() when it expires in a
+ * TimerWheel
+ *
+ * A timer allocates nothing, keep it in the object it times out (e.g. one
+ * per network connection). Destroying the timer stops it, and the slot
+ * methods connected to timeout() are disconnected when their observers are
+ * destroyed, so there's nothing to cancel by hand.
+ *
+ * Start(), Stop() and Restart() are O(1).
+ */
+class WIZTK_EXPORT Timer : private internal::TimerNode {
+
+  friend class TimerWheel;
+
+ public:
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(Timer);
+
+  Timer() = default;
+
+  /**
+   * @brief Destructor, stops the timer
+   */
+  ~Timer();
+
+  /**
+   * @brief Start or restart the timer to expire after the given ticks of the
+   * wheel
+   *
+   * The timeout is emitted by the TimerWheel::Advance() which reaches the
+   * tick, 0 ticks is the same as 1.
+   */
+  void Start(TimerWheel &wheel, uint64_t ticks);
+
+  /**
+   * @brief Start again with the wheel and ticks given to the last Start()
+   */
+  void Restart();
+
+  void Stop();
+
+  bool IsActive() const {
+    return !empty();
+  }
+
+  /**
+   * @brief The tick the timer expires at if it's active
+   */
+  uint64_t expires() const {
+    return expires_;
+  }
+
+  SignalRef<> timeout() {
+    return timeout_;
+  }
+
+ private:
+
+  TimerWheel *wheel_ = nullptr;
+
+  uint64_t ticks_ = 0;
+
+  uint64_t expires_ = 0;
+
+  Signal<> timeout_;
+
+};
+
+/**
+ * @ingroup base
+ * @brief A hierarchical timer wheel driving Timer objects
+ *
+ * The first level has 256 slots of one tick, each of the 4 levels above has
+ * 64 slots covering a whole turn of the level below. A timer is put in the
+ * level its remaining ticks fall in, and moved down when the level below
+ * reaches its slot, as in the timers of the Linux kernel. Starting and
+ * stopping a timer are O(1), a timer is moved at most 4 times.
+ *
+ * Drive the wheel by calling Advance() with the ticks passed, or Poll() with
+ * the current time in the loop of your thread, e.g. in a task posted to an
+ * EventLoop. Timers expire in the thread calling Advance(), a wheel and its
+ * timers are used in one thread.
+ */
+class WIZTK_EXPORT TimerWheel {
+
+  friend class Timer;
+
+ public:
+
+  typedef std::chrono::steady_clock Clock;
+
+  WIZTK_DECLARE_NONCOPYABLE_AND_NONMOVALE(TimerWheel);
+
+  /**
+   * @brief Create a wheel whose tick is the given duration for Poll()
+   */
+  explicit TimerWheel(Clock::duration tick = std::chrono::milliseconds(1));
+
+  /**
+   * @brief Destructor, stops all timers
+   */
+  ~TimerWheel();
+
+  /**
+   * @brief Move the wheel forward and emit the timeout of the timers expired
+   * @return The number of timers expired
+   *
+   * Slot methods may start, stop or destroy any timer, but must not call
+   * Advance() or destroy the wheel.
+   */
+  size_t Advance(uint64_t ticks = 1);
+
+  /**
+   * @brief Advance to the tick of the given time since this wheel was created
+   */
+  size_t Poll(Clock::time_point now = Clock::now());
+
+  /**
+   * @brief The current tick
+   */
+  uint64_t now() const {
+    return now_;
+  }
+
+  size_t CountTimers() const {
+    return count_;
+  }
+
+ private:
+
+  static constexpr int kLevels = 5;
+  static constexpr int kFirstBits = 8;
+  static constexpr int kLevelBits = 6;
+  static constexpr uint64_t kFirstSize = 1 << kFirstBits;
+  static constexpr uint64_t kLevelSize = 1 << kLevelBits;
+
+  /**
+   * @brief Put an active timer in the slot of its expiry
+   */
+  void Place(Timer *timer);
+
+  /**
+   * @brief Move the timers of the slot at the current tick of a level down
+   * @return The index of the slot
+   */
+  uint64_t Cascade(int level);
+
+  internal::TimerNode *SlotAt(int level, uint64_t index) {
+    return (0 == level) ? &first_[index] : &levels_[level - 1][index];
+  }
+
+  internal::TimerNode first_[kFirstSize];
+
+  internal::TimerNode levels_[kLevels - 1][kLevelSize];
+
+  /**
+   * @brief The timers expired in this tick and not emitted yet
+   */
+  internal::TimerNode expired_;
+
+  uint64_t now_ = 0;
+
+  size_t count_ = 0;
+
+  bool advancing_ = false;
+
+  Clock::time_point origin_;
+
+  Clock::duration tick_;
+
+};
+
+} // namespace sigcxx
+
+#endif  // WIZTK_BASE_TIMER_WHEEL_HPP_
@@ -0,0 +1,295 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "sigcxx/epoch.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace sigcxx {
+namespace internal {
+
+namespace {
+
+constexpr uint64_t kQuiescent = 0;
+
+constexpr size_t kCacheLine = 64;
+
+/**
+ * @brief Allocate memory aligned to a cache line
+ *
+ * Operator new only guarantees the alignment of max_align_t before C++17,
+ * allocate more and keep the original pointer right before the aligned one.
+ */
+void *AllocateAligned(size_t size) {
+  char *raw = static_cast<char *>(::operator new(size + kCacheLine + sizeof(void *)));
+  uintptr_t address = reinterpret_cast<uintptr_t>(raw + sizeof(void *));
+  address = (address + kCacheLine - 1) & ~static_cast<uintptr_t>(kCacheLine - 1);
+  reinterpret_cast<void **>(address)[-1] = raw;
+  return reinterpret_cast<void *>(address);
+}
+
+void FreeAligned(void *p) {
+  ::operator delete(static_cast<void **>(p)[-1]);
+}
+
+/**
+ * @brief The epoch announced by a thread, on its own cache line
+ *
+ * Records are never freed, a record released by an exited thread is reused
+ * by the next new thread.
+ */
+struct alignas(64) ThreadRecord {
+  std::atomic<uint64_t> epoch{kQuiescent};
+  std::atomic<bool> in_use{true};
+  ThreadRecord *next = nullptr;  // not changed once published
+};
+
+struct RetiredObject {
+  void *object;
+  void (*deleter)(void *);
+  uint64_t epoch;
+};
+
+/**
+ * @brief The global state, never destroyed as threads may exit after main()
+ */
+struct Domain {
+
+  /**
+   * @brief Advance the global epoch if all threads inside have seen it
+   *
+   * Called with the lock held.
+   */
+  bool TryAdvance() {
+    // Pairs with the fence in EpochDomain::Enter()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t current = epoch.load();
+    for (ThreadRecord *record = records.load(); record; record = record->next) {
+      uint64_t seen = record->epoch.load();
+      if ((kQuiescent != seen) && (seen != current)) return false;
+    }
+    return epoch.compare_exchange_strong(current, current + 1);
+  }
+
+  /**
+   * @brief Free the objects no reader can access, called with the lock held
+   */
+  void FreeRetired() {
+    // Two advances let every reader inside when an object is retired leave
+    for (int i = 0; i < 2; i++) {
+      if (!TryAdvance()) break;
+    }
+
+    uint64_t current = epoch.load();
+    size_t kept = 0;
+    for (RetiredObject &item : retired) {
+      if (item.epoch + 2 <= current) {
+        item.deleter(item.object);
+      } else {
+        retired[kept++] = item;
+      }
+    }
+    retired.resize(kept);
+  }
+
+  ThreadRecord *Acquire() {
+    for (ThreadRecord *record = records.load(); record; record = record->next) {
+      bool expected = false;
+      if ((!record->in_use.load(std::memory_order_relaxed)) && record->in_use.compare_exchange_strong(expected, true)) {
+        return record;
+      }
+    }
+
+    auto *record = new(AllocateAligned(sizeof(ThreadRecord))) ThreadRecord;
+    record->next = records.load();
+    while (!records.compare_exchange_weak(record->next, record)) {}
+    return record;
+  }
+
+  std::atomic<uint64_t> epoch{1};
+  std::atomic<ThreadRecord *> records{nullptr};
+  std::mutex mutex;
+  std::vector<RetiredObject> retired;
+
+};
+
+Domain *GetDomain() {
+  static Domain *domain = new Domain;
+  return domain;
+}
+
+/**
+ * @brief The record of this thread and the nesting depth of Enter()
+ *
+ * Trivially destructible so that it's still usable after the thread local
+ * Releaser is destroyed.
+ */
+struct LocalState {
+  ThreadRecord *record;
+  unsigned depth;
+  bool released;
+};
+
+thread_local LocalState local;
+
+/**
+ * @brief Releases the record of a thread when it exits
+ */
+struct Releaser {
+
+  Releaser() = default;
+
+  ~Releaser() {
+    if (nullptr != local.record) {
+      local.record->epoch.store(kQuiescent);
+      local.record->in_use.store(false);
+      local.record = nullptr;
+    }
+    local.released = true;
+  }
+
+  bool registered = false;
+
+};
+
+thread_local Releaser releaser;
+
+} // namespace
+
+void EpochDomain::Enter() {
+  if (0 == local.depth++) {
+    Domain *domain = GetDomain();
+    if (nullptr == local.record) {
+      local.record = domain->Acquire();
+      // Touch the thread local releaser so its destructor runs at thread
+      // exit, a record acquired after that is never released
+      if (!local.released) releaser.registered = true;
+    }
+    local.record->epoch.store(domain->epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    // The announcement must be visible before any shared pointer is loaded
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+}
+
+void EpochDomain::Exit() {
+  _ASSERT(local.depth > 0);
+  if (0 == --local.depth) {
+    local.record->epoch.store(kQuiescent, std::memory_order_release);
+  }
+}
+
+void EpochDomain::Retire(void *object, void (*deleter)(void *)) {
+  Domain *domain = GetDomain();
+  std::lock_guard<std::mutex> lock(domain->mutex);
+  domain->retired.push_back(RetiredObject{object, deleter, domain->epoch.load()});
+  domain->FreeRetired();
+}
+
+void EpochDomain::Collect() {
+  Domain *domain = GetDomain();
+  std::lock_guard<std::mutex> lock(domain->mutex);
+  domain->FreeRetired();
+}
+
+size_t EpochDomain::CountRetired() {
+  Domain *domain = GetDomain();
+  std::lock_guard<std::mutex> lock(domain->mutex);
+  return domain->retired.size();
+}
+
+// ------
+
+namespace {
+
+/**
+ * @brief The EmissionScopes of the current thread
+ */
+struct ScopeStack {
+  EmissionScope *top = nullptr;
+  size_t stripe = static_cast<size_t>(-1);
+};
+
+thread_local ScopeStack scopes;
+
+std::atomic<size_t> next_stripe{0};
+
+} // namespace
+
+EmissionBarrier::EmissionBarrier()
+    : stripes_(static_cast<Stripe *>(AllocateAligned(kStripes * sizeof(Stripe)))) {
+  for (size_t i = 0; i < kStripes; i++) new(&stripes_[i]) Stripe();
+}
+
+EmissionBarrier::~EmissionBarrier() {
+  // Stripe is trivially destructible
+  FreeAligned(stripes_);
+}
+
+EmissionScope::EmissionScope(EmissionBarrier *barrier)
+    : outer_(scopes.top) {
+  if (static_cast<size_t>(-1) == scopes.stripe) {
+    scopes.stripe = next_stripe.fetch_add(1, std::memory_order_relaxed) % EmissionBarrier::kStripes;
+  }
+
+  size_t phase = barrier->phase_.load(std::memory_order_relaxed) & 1;
+  counter_ = &barrier->stripes_[scopes.stripe].counters[phase];
+  counter_->fetch_add(1);
+  scopes.top = this;
+}
+
+EmissionScope::~EmissionScope() {
+  scopes.top = outer_;
+  counter_->fetch_sub(1, std::memory_order_release);
+}
+
+size_t EmissionBarrier::Count(size_t phase) const {
+  size_t count = 0;
+  for (size_t i = 0; i < kStripes; i++) {
+    count += stripes_[i].counters[phase].load();
+  }
+  return count;
+}
+
+bool EmissionScope::IsEmitting() {
+  return nullptr != scopes.top;
+}
+
+void EmissionBarrier::Wait() {
+  // No emission of this thread is counted, and no waiter waits for this one
+  _ASSERT(nullptr == scopes.top);
+
+  // The lock keeps waiters from flipping the phase back and forth, it's not
+  // needed to be correct
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Drain each phase while new emissions are counted in the other one
+  for (size_t i = 0; i < 2; i++) {
+    while (Count(i) > 0) {
+      size_t phase = phase_.load();
+      if ((phase & 1) == i) phase_.compare_exchange_strong(phase, phase + 1);
+      std::this_thread::yield();
+    }
+  }
+}
+
+} // namespace internal
+} // namespace sigcxx
@@ -0,0 +1,97 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sigcxx/event_loop.hpp"
+
+namespace sigcxx {
+
+EventLoop::~EventLoop() {
+  Task *task = nullptr;
+  while (nullptr != (task = queue_.Pop())) {
+    task->Discard();
+  }
+}
+
+void EventLoop::Post(Task *task) {
+  queue_.Push(task);
+
+  // Pairs with Wait(): either this sees sleeping_, or the loop sees the task
+  if (sleeping_.load()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    signaled_ = true;
+    wake_.notify_one();
+  }
+}
+
+void EventLoop::Run() {
+  while (!quit_.exchange(false, std::memory_order_acquire)) {
+    if (0 == RunOnce()) return;  // quit in RunOnce(), already cleared
+  }
+}
+
+size_t EventLoop::RunOnce() {
+  size_t count = RunUntilQuit();
+  while ((0 == count) && (!quit_.load(std::memory_order_acquire))) {
+    Wait();
+    count = RunUntilQuit();
+  }
+  if (0 == count) quit_.store(false, std::memory_order_relaxed);
+  return count;
+}
+
+size_t EventLoop::Drain(size_t max_items) {
+  size_t count = 0;
+  Task *task = nullptr;
+
+  while ((count < max_items) && (nullptr != (task = queue_.Pop()))) {
+    task->Run();
+    count++;
+  }
+  return count;
+}
+
+size_t EventLoop::RunUntilQuit() {
+  size_t count = 0;
+  Task *task = nullptr;
+
+  while ((!quit_.load(std::memory_order_acquire)) && (nullptr != (task = queue_.Pop()))) {
+    task->Run();
+    count++;
+  }
+  return count;
+}
+
+void EventLoop::Quit() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  quit_.store(true, std::memory_order_release);
+  signaled_ = true;
+  wake_.notify_one();
+}
+
+void EventLoop::Wait() {
+  sleeping_.store(true);
+
+  // A task pushed but not linked yet counts as one, Pop() would miss it
+  if (queue_.IsEmpty()) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!signaled_) wake_.wait(lock);
+    signaled_ = false;
+  }
+
+  sleeping_.store(false, std::memory_order_relaxed);
+}
+
+} // namespace sigcxx
@@ -0,0 +1,88 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sigcxx/executor.hpp"
+
+namespace sigcxx {
+
+namespace internal {
+
+// The queue always holds at least one node: tail_ is the next node to pop
+// and the stub is pushed again whenever the last real task is popped. See
+// Dmitry Vyukov's intrusive MPSC node-based queue.
+
+MpscQueue::MpscQueue()
+    : head_(&stub_), tail_(&stub_), stub_(nullptr) {}
+
+void MpscQueue::Push(Task *task) {
+  task->next_.store(nullptr, std::memory_order_relaxed);
+  Task *prev = head_.exchange(task, std::memory_order_acq_rel);
+  prev->next_.store(task, std::memory_order_release);
+}
+
+Task *MpscQueue::Pop() {
+  Task *tail = tail_;
+  Task *next = tail->next_.load(std::memory_order_acquire);
+
+  if (tail == &stub_) {
+    if (nullptr == next) return nullptr;
+    tail_ = next;
+    tail = next;
+    next = next->next_.load(std::memory_order_acquire);
+  }
+
+  if (nullptr != next) {
+    tail_ = next;
+    return tail;
+  }
+
+  // tail is the last task unless a push is in progress
+  if (tail != head_.load(std::memory_order_acquire)) return nullptr;
+
+  Push(&stub_);
+  next = tail->next_.load(std::memory_order_acquire);
+  if (nullptr != next) {
+    tail_ = next;
+    return tail;
+  }
+  return nullptr;
+}
+
+}  // namespace internal
+
+TaskQueue::~TaskQueue() {
+  Task *task = nullptr;
+  while (nullptr != (task = queue_.Pop())) {
+    task->Discard();
+  }
+}
+
+void TaskQueue::Post(Task *task) {
+  queue_.Push(task);
+}
+
+size_t TaskQueue::RunPending() {
+  size_t count = 0;
+  Task *task = nullptr;
+
+  while (nullptr != (task = queue_.Pop())) {
+    task->Run();
+    count++;
+  }
+  return count;
+}
+
+} // namespace sigcxx
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "sigcxx/method_index.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+namespace sigcxx {
+namespace internal {
+
+size_t MethodIndex::Hash(const void *object, GenericMethodPointer method) {
+  // A member function pointer may be larger than a data pointer
+  uintptr_t words[sizeof(GenericMethodPointer) / sizeof(uintptr_t)];
+  std::memcpy(words, &method, sizeof(words));
+
+  size_t hash = reinterpret_cast<uintptr_t>(object);
+  for (uintptr_t word : words) {
+    hash ^= word + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+void MethodIndex::Insert(MethodIndexNode *node, size_t hash) {
+  if (size_ >= buckets_.size()) {
+    Rehash(buckets_.empty() ? 64 : buckets_.size() * 2);
+  }
+
+  node->hash = hash;
+  Link(node, &buckets_[hash & (buckets_.size() - 1)]);
+  size_++;
+}
+
+void MethodIndex::Erase(MethodIndexNode *node) {
+  _ASSERT(nullptr != node->pprev_in_bucket);
+
+  *node->pprev_in_bucket = node->next_in_bucket;
+  if (nullptr != node->next_in_bucket) node->next_in_bucket->pprev_in_bucket = node->pprev_in_bucket;
+  node->next_in_bucket = nullptr;
+  node->pprev_in_bucket = nullptr;
+
+  size_--;
+  if (0 == size_) Clear();
+}
+
+MethodIndexNode *MethodIndex::Find(size_t hash) const {
+  if (buckets_.empty()) return nullptr;
+
+  MethodIndexNode *node = buckets_[hash & (buckets_.size() - 1)];
+  while ((nullptr != node) && (node->hash != hash)) {
+    node = node->next_in_bucket;
+  }
+  return node;
+}
+
+MethodIndexNode *MethodIndex::FindNext(const MethodIndexNode *node) {
+  MethodIndexNode *next = node->next_in_bucket;
+  while ((nullptr != next) && (next->hash != node->hash)) {
+    next = next->next_in_bucket;
+  }
+  return next;
+}
+
+void MethodIndex::Clear() {
+  std::vector<MethodIndexNode *>().swap(buckets_);
+  size_ = 0;
+}
+
+void MethodIndex::Rehash(size_t bucket_count) {
+  std::vector<MethodIndexNode *> buckets(bucket_count, nullptr);
+
+  for (MethodIndexNode *node : buckets_) {
+    while (nullptr != node) {
+      MethodIndexNode *next = node->next_in_bucket;
+      Link(node, &buckets[node->hash & (bucket_count - 1)]);
+      node = next;
+    }
+  }
+
+  buckets_.swap(buckets);
+}
+
+void MethodIndex::Link(MethodIndexNode *node, MethodIndexNode **bucket) {
+  node->next_in_bucket = *bucket;
+  node->pprev_in_bucket = bucket;
+  if (nullptr != *bucket) (*bucket)->pprev_in_bucket = &node->next_in_bucket;
+  *bucket = node;
+}
+
+} // namespace internal
+} // namespace sigcxx
@@ -0,0 +1,306 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "sigcxx/node_pool.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <set>
+
+namespace sigcxx {
+namespace internal {
+
+namespace {
+
+void *DefaultAllocate(size_t size) {
+  return ::operator new(size);
+}
+
+void DefaultDeallocate(void *p, size_t /* size */) {
+  ::operator delete(p);
+}
+
+inline size_t ClassOf(size_t size) {
+  return (size + NodePool::kAlignment - 1) / NodePool::kAlignment - 1;
+}
+
+inline size_t SizeOfClass(size_t size_class) {
+  return (size_class + 1) * NodePool::kAlignment;
+}
+
+/**
+ * @brief The header at the start of a slab, the blocks of one size class
+ * follow it
+ */
+struct Slab {
+  Slab *previous;  // in the list of slabs with free blocks
+  Slab *next;
+  void *free_blocks;  // linked through the first word of each free block
+  size_t free_count;
+};
+
+constexpr size_t kSlabHeaderSize =
+    (sizeof(Slab) + NodePool::kAlignment - 1) / NodePool::kAlignment * NodePool::kAlignment;
+
+inline size_t BlocksInSlab(size_t size_class) {
+  return (NodePool::kSlabSize - kSlabHeaderSize) / SizeOfClass(size_class);
+}
+
+/**
+ * @brief The global free blocks, shared by all threads
+ *
+ * The free blocks are kept in their slabs. A slab whose blocks are all free
+ * again is returned to the allocator, except one kept for each size class so
+ * that a thread connecting and disconnecting in a loop does not get a new
+ * slab each time.
+ *
+ * Never destroyed: nodes may be freed by static objects after main() returns.
+ */
+struct Depot {
+
+  void Refill(size_t size_class, void **blocks, size_t *count, size_t wanted) {
+    std::lock_guard<std::mutex> lock(mutex);
+    used.store(true, std::memory_order_relaxed);
+
+    while (*count < wanted) {
+      Slab *slab = partial[size_class];
+      if (nullptr == slab) slab = NewSlab(size_class);
+      if (BlocksInSlab(size_class) == slab->free_count) empty_count[size_class]--;
+
+      while ((*count < wanted) && (slab->free_count > 0)) {
+        void *block = slab->free_blocks;
+        slab->free_blocks = *static_cast<void **>(block);
+        slab->free_count--;
+        blocks[(*count)++] = block;
+      }
+
+      if (0 == slab->free_count) Unlink(size_class, slab);
+    }
+  }
+
+  void Spill(size_t size_class, void **blocks, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    for (size_t i = 0; i < count; i++) {
+      Slab *slab = SlabOf(blocks[i]);
+      if (0 == slab->free_count) Link(size_class, slab);
+
+      *static_cast<void **>(blocks[i]) = slab->free_blocks;
+      slab->free_blocks = blocks[i];
+      slab->free_count++;
+
+      if (BlocksInSlab(size_class) == slab->free_count) {
+        if (empty_count[size_class] > 0) {
+          Unlink(size_class, slab);
+          slabs.erase(reinterpret_cast<char *>(slab));
+          allocator.deallocate(slab, NodePool::kSlabSize);
+        } else {
+          empty_count[size_class]++;
+        }
+      }
+    }
+  }
+
+  Slab *NewSlab(size_t size_class) {
+    auto *memory = static_cast<char *>(allocator.allocate(NodePool::kSlabSize));
+    auto *slab = reinterpret_cast<Slab *>(memory);
+    size_t block_size = SizeOfClass(size_class);
+    size_t block_count = BlocksInSlab(size_class);
+
+    slab->free_blocks = nullptr;
+    for (size_t i = block_count; i > 0; i--) {
+      void *block = memory + kSlabHeaderSize + (i - 1) * block_size;
+      *static_cast<void **>(block) = slab->free_blocks;
+      slab->free_blocks = block;
+    }
+    slab->free_count = block_count;
+
+    slabs.insert(memory);
+    Link(size_class, slab);
+    empty_count[size_class]++;
+    return slab;
+  }
+
+  /**
+   * @brief Find the slab of a block by its address, O(log n) of the slabs
+   */
+  Slab *SlabOf(void *block) const {
+    auto it = slabs.upper_bound(static_cast<char *>(block));
+    _ASSERT(it != slabs.begin());
+    --it;
+    return reinterpret_cast<Slab *>(*it);
+  }
+
+  void Link(size_t size_class, Slab *slab) {
+    slab->previous = nullptr;
+    slab->next = partial[size_class];
+    if (nullptr != slab->next) slab->next->previous = slab;
+    partial[size_class] = slab;
+  }
+
+  void Unlink(size_t size_class, Slab *slab) {
+    if (nullptr != slab->previous) {
+      slab->previous->next = slab->next;
+    } else {
+      partial[size_class] = slab->next;
+    }
+    if (nullptr != slab->next) slab->next->previous = slab->previous;
+  }
+
+  std::mutex mutex;
+
+  /**
+   * @brief The slabs with free blocks of each size class
+   */
+  Slab *partial[NodePool::kClassCount] = {};
+
+  /**
+   * @brief The number of slabs without any block in use of each size class
+   */
+  size_t empty_count[NodePool::kClassCount] = {};
+
+  /**
+   * @brief The addresses of all slabs, to find the slab of a block
+   */
+  std::set<char *> slabs;
+
+  NodeAllocator allocator = {DefaultAllocate, DefaultDeallocate};
+
+  std::atomic<bool> used{false};
+
+};
+
+Depot *GetDepot() {
+  static Depot *depot = new Depot;
+  return depot;
+}
+
+/**
+ * @brief The free blocks kept by a thread
+ *
+ * Trivially destructible so that it's still usable after the thread local
+ * Flusher is destroyed: then blocks go to the depot directly.
+ */
+struct Magazines {
+  void *blocks[NodePool::kClassCount][NodePool::kMagazineSize];
+  size_t counts[NodePool::kClassCount];
+  ptrdiff_t bytes;  // see NodePool::CountThreadBytes()
+  bool flushed;
+};
+
+thread_local Magazines magazines;
+
+/**
+ * @brief Returns the blocks in the magazines to the depot when the thread
+ * exits
+ */
+struct Flusher {
+
+  Flusher() = default;
+
+  ~Flusher() {
+    for (size_t i = 0; i < NodePool::kClassCount; i++) {
+      if (magazines.counts[i] > 0) GetDepot()->Spill(i, magazines.blocks[i], magazines.counts[i]);
+      magazines.counts[i] = 0;
+    }
+    magazines.flushed = true;
+  }
+
+  bool registered = false;
+
+};
+
+thread_local Flusher flusher;
+
+} // namespace
+
+void *NodePool::Allocate(size_t size) {
+  if (size > kMaxSize) {
+    magazines.bytes += size;
+    Depot *depot = GetDepot();
+    depot->used.store(true, std::memory_order_relaxed);
+    return depot->allocator.allocate(size);
+  }
+
+  size_t size_class = ClassOf(size);
+  size_t &count = magazines.counts[size_class];
+  magazines.bytes += SizeOfClass(size_class);
+
+  if (0 == count) {
+    Depot *depot = GetDepot();
+
+    if (magazines.flushed) {
+      void *block = nullptr;
+      size_t n = 0;
+      depot->Refill(size_class, &block, &n, 1);
+      return block;
+    }
+
+    // Touch the thread local flusher so its destructor runs at thread exit
+    flusher.registered = true;
+    depot->Refill(size_class, magazines.blocks[size_class], &count, kMagazineSize / 2);
+  }
+
+  return magazines.blocks[size_class][--count];
+}
+
+void NodePool::Deallocate(void *p, size_t size) {
+  if (size > kMaxSize) {
+    magazines.bytes -= size;
+    GetDepot()->allocator.deallocate(p, size);
+    return;
+  }
+
+  size_t size_class = ClassOf(size);
+  size_t &count = magazines.counts[size_class];
+  magazines.bytes -= SizeOfClass(size_class);
+
+  if (magazines.flushed) {
+    GetDepot()->Spill(size_class, &p, 1);
+    return;
+  }
+
+  if (0 == count) {
+    flusher.registered = true;
+  } else if (kMagazineSize == count) {
+    // Keep half of the magazine for the next allocations
+    count -= kMagazineSize / 2;
+    GetDepot()->Spill(size_class, &magazines.blocks[size_class][count], kMagazineSize / 2);
+  }
+
+  magazines.blocks[size_class][count++] = p;
+}
+
+ptrdiff_t NodePool::CountThreadBytes() {
+  return magazines.bytes;
+}
+
+} // namespace internal
+
+bool SetNodeAllocator(const NodeAllocator &allocator) {
+  internal::Depot *depot = internal::GetDepot();
+
+  std::lock_guard<std::mutex> lock(depot->mutex);
+  if (depot->used.load(std::memory_order_relaxed)) return false;
+
+  depot->allocator = allocator;
+  return true;
+}
+
+} // namespace sigcxx
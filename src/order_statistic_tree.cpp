@@ -0,0 +1,146 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sigcxx/order_statistic_tree.hpp"
+
+namespace sigcxx {
+namespace internal {
+
+void OrderStatisticTree::Insert(OrderStatisticNode *node, size_t position) {
+  _ASSERT(position <= size());
+
+  node->parent = nullptr;
+  node->left = nullptr;
+  node->right = nullptr;
+  node->size = 1;
+  node->priority = NextPriority();
+
+  OrderStatisticNode *left = nullptr;
+  OrderStatisticNode *right = nullptr;
+  Split(root_, position, &left, &right);
+  root_ = Merge(Merge(left, node), right);
+  root_->parent = nullptr;
+}
+
+void OrderStatisticTree::Erase(OrderStatisticNode *node) {
+  OrderStatisticNode *child = Merge(node->left, node->right);
+  OrderStatisticNode *parent = node->parent;
+
+  if (nullptr != child) child->parent = parent;
+
+  if (nullptr == parent) {
+    _ASSERT(root_ == node);
+    root_ = child;
+  } else {
+    if (parent->left == node) {
+      parent->left = child;
+    } else {
+      parent->right = child;
+    }
+    for (OrderStatisticNode *p = parent; p; p = p->parent) {
+      p->size--;
+    }
+  }
+
+  node->parent = nullptr;
+  node->left = nullptr;
+  node->right = nullptr;
+  node->size = 1;
+}
+
+OrderStatisticNode *OrderStatisticTree::At(size_t position) const {
+  OrderStatisticNode *node = root_;
+
+  while (nullptr != node) {
+    size_t left_size = SizeOf(node->left);
+    if (position < left_size) {
+      node = node->left;
+    } else if (position == left_size) {
+      return node;
+    } else {
+      position -= left_size + 1;
+      node = node->right;
+    }
+  }
+
+  return nullptr;
+}
+
+size_t OrderStatisticTree::PositionOf(const OrderStatisticNode *node) {
+  size_t position = SizeOf(node->left);
+
+  while (nullptr != node->parent) {
+    if (node->parent->right == node) {
+      position += SizeOf(node->parent->left) + 1;
+    }
+    node = node->parent;
+  }
+
+  return position;
+}
+
+void OrderStatisticTree::Update(OrderStatisticNode *node) {
+  node->size = static_cast<uint32_t>(1 + SizeOf(node->left) + SizeOf(node->right));
+  if (nullptr != node->left) node->left->parent = node;
+  if (nullptr != node->right) node->right->parent = node;
+}
+
+void OrderStatisticTree::Split(OrderStatisticNode *tree,
+                               size_t count,
+                               OrderStatisticNode **left,
+                               OrderStatisticNode **right) {
+  if (nullptr == tree) {
+    *left = nullptr;
+    *right = nullptr;
+    return;
+  }
+
+  if (SizeOf(tree->left) < count) {
+    Split(tree->right, count - SizeOf(tree->left) - 1, &tree->right, right);
+    Update(tree);
+    *left = tree;
+  } else {
+    Split(tree->left, count, left, &tree->left);
+    Update(tree);
+    *right = tree;
+  }
+}
+
+OrderStatisticNode *OrderStatisticTree::Merge(OrderStatisticNode *left, OrderStatisticNode *right) {
+  if (nullptr == left) return right;
+  if (nullptr == right) return left;
+
+  if (left->priority > right->priority) {
+    left->right = Merge(left->right, right);
+    Update(left);
+    return left;
+  }
+
+  right->left = Merge(left, right->left);
+  Update(right);
+  return right;
+}
+
+uint32_t OrderStatisticTree::NextPriority() {
+  // xorshift32
+  seed_ ^= seed_ << 13;
+  seed_ ^= seed_ >> 17;
+  seed_ ^= seed_ << 5;
+  return seed_;
+}
+
+} // namespace internal
+} // namespace sigcxx
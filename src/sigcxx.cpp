@@ -15,12 +15,20 @@
  */
 
 #include "sigcxx/sigcxx.hpp"
+#include "sigcxx/thread_pool.hpp"
+
+#include <algorithm>
+#include <thread>
 
 namespace sigcxx {
 
 namespace internal {
 
 TrackableBindingNode::~TrackableBindingNode() {
+  if (nullptr != trackable) {
+    trackable->bindings_.erase(this);
+  }
+
   if (nullptr != token) {
     _ASSERT(token->binding == this);
     token->binding = nullptr;
@@ -29,13 +37,13 @@ TrackableBindingNode::~TrackableBindingNode() {
 }
 
 SignalTokenNode::~SignalTokenNode() {
-  _ASSERT(nullptr == slot_mark_head.previous());
-  Slot::Mark *mark = nullptr;
-  while (nullptr != slot_mark_head.next()) {
-    mark = static_cast<Slot::Mark *>(slot_mark_head.next());
-    ++mark->slot()->it_;
-    ++mark->slot()->ref_count_;
-    mark->unlink();
+  if (nullptr != connection) {
+    _ASSERT(connection->token_ == this);
+    connection->token_ = nullptr;
+  }
+
+  if (nullptr != trackable) {
+    trackable->OnTokenRemoved(this);
   }
 
   if (nullptr != binding) {
@@ -45,8 +53,74 @@ SignalTokenNode::~SignalTokenNode() {
   }
 }
 
+void SignalTokenNode::SetBlocked(bool blocked) {
+  if (this->blocked == blocked) return;
+
+  this->blocked = blocked;
+  if (nullptr != trackable) {
+    trackable->OnTokenBlocked(this);
+  }
+}
+
+void WaitSpinLock(std::atomic_flag *flag) {
+  do {
+    std::this_thread::yield();
+  } while (flag->test_and_set(std::memory_order_acquire));
+}
+
+void ParallelEmit(ThreadPool &pool, size_t count, void (*function)(void *, size_t, size_t), void *context) {
+  size_t grain = std::max(count / (8 * (pool.CountThreads() + 1)), static_cast<size_t>(64));
+  pool.ParallelFor(count, grain, function, context);
+}
+
 }  // namespace internal
 
+Connection::Connection(internal::SignalTokenNode *token)
+    : token_(token) {
+  _ASSERT(nullptr == token->connection);
+  token->connection = this;
+}
+
+Connection::Connection(Connection &&other) noexcept
+    : token_(other.token_) {
+  other.token_ = nullptr;
+  if (nullptr != token_) token_->connection = this;
+}
+
+Connection::~Connection() {
+  Reset();
+}
+
+Connection &Connection::operator=(Connection &&other) noexcept {
+  if (this != &other) {
+    Reset();
+    token_ = other.token_;
+    other.token_ = nullptr;
+    if (nullptr != token_) token_->connection = this;
+  }
+  return *this;
+}
+
+void Connection::Disconnect() {
+  if (nullptr != token_) {
+    delete token_;  // clears token_
+    _ASSERT(nullptr == token_);
+  }
+}
+
+void Connection::Block(bool blocked) {
+  if (nullptr != token_) {
+    token_->SetBlocked(blocked);
+  }
+}
+
+void Connection::Reset() {
+  if (nullptr != token_) {
+    token_->connection = nullptr;
+    token_ = nullptr;
+  }
+}
+
 Trackable::Trackable(const Trackable &)
     : Trackable() {}
 
@@ -57,29 +131,30 @@ Trackable::~Trackable() {
 void Trackable::UnbindSignal(SLOT slot) {
   using internal::SignalTokenNode;
 
-  if (slot->it_.get()->binding->trackable == this) {
+  if ((!slot->removed_) && (slot->it_.get()->binding->trackable == this)) {
+    if (slot->deferred_) {  // removed by EmitParallel() when all chunks are done
+      slot->unbind_ = true;
+      return;
+    }
     SignalTokenNode *tmp = slot->it_.get();
     delete tmp;
   }
 }
 
 void Trackable::UnbindAllSignals() {
-  internal::TrackableBindingNode *tmp = nullptr;
-
-  internal::InterRelatedDeque<internal::TrackableBindingNode>::ReverseIterator it = bindings_.rbegin();
-  while (it) {
-    tmp = it.get();
-    delete tmp;
-    it = bindings_.rbegin();
-  }
-}
-
-size_t Trackable::CountSignalBindings() const {
-  size_t count = 0;
-  for (auto it = bindings_.cbegin(); it != bindings_.cend(); ++it) {
-    count++;
+  // Detach all bindings from this object at once, the tokens are still
+  // removed from each signal one by one. There's no batch path here: every
+  // token is in a different place of a different signal, and the freed
+  // records already go to the thread-local magazines of the node pool.
+  internal::TrackableBindingNode *binding = bindings_.detach_all();
+  internal::TrackableBindingNode *next = nullptr;
+
+  while (binding) {
+    next = static_cast<internal::TrackableBindingNode *>(binding->next());
+    binding->trackable = nullptr;
+    delete binding;
+    binding = next;
   }
-  return count;
 }
 
 // ------
@@ -0,0 +1,243 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sigcxx/thread_pool.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sigcxx {
+namespace internal {
+
+namespace {
+
+/**
+ * @brief One ParallelFor() call, on the stack of the calling thread
+ */
+struct ParallelJob {
+  ThreadPool::RangeFunction function;
+  void *context;
+  size_t grain;
+  std::atomic<size_t> remaining;  // indices not run yet
+};
+
+struct WorkItem {
+  ParallelJob *job;
+  size_t begin;
+  size_t end;
+};
+
+/**
+ * @brief The deque of a worker, the owner uses the back and thieves the front
+ */
+class WorkQueue {
+
+ public:
+
+  void PushBack(const WorkItem &item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    items_.push_back(item);
+  }
+
+  bool PopBack(WorkItem *item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (items_.empty()) return false;
+    *item = items_.back();
+    items_.pop_back();
+    return true;
+  }
+
+  bool StealFront(WorkItem *item) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (items_.empty()) return false;
+    *item = items_.front();
+    items_.pop_front();
+    return true;
+  }
+
+ private:
+
+  std::mutex mutex_;
+  std::deque<WorkItem> items_;
+
+};
+
+}  // namespace
+
+struct ThreadPoolState {
+
+  /**
+   * @brief One queue for each worker, and the last one shared by the threads
+   * outside the pool
+   */
+  std::vector<std::unique_ptr<WorkQueue>> queues;
+
+  std::vector<std::thread> threads;
+
+  std::atomic<size_t> pending{0};  // items in all queues
+
+  std::atomic<size_t> sleepers{0};
+
+  std::mutex sleep_mutex;
+
+  std::condition_variable wake;
+
+  bool stop = false;  // guarded by sleep_mutex
+
+  void Push(size_t queue, const WorkItem &item);
+
+  bool FindWork(size_t queue, WorkItem *item);
+
+  void Execute(size_t queue, WorkItem item);
+
+  void RunWorker(size_t queue);
+
+  size_t CurrentQueue() const;
+
+};
+
+namespace {
+
+/**
+ * @brief The pool and queue of the current thread if it's a worker
+ */
+thread_local const ThreadPoolState *current_pool = nullptr;
+thread_local size_t current_queue = 0;
+
+}  // namespace
+
+void ThreadPoolState::Push(size_t queue, const WorkItem &item) {
+  queues[queue]->PushBack(item);
+  pending.fetch_add(1);
+
+  // Pairs with the increment of sleepers before a worker waits, one of the
+  // two sees the other
+  if (sleepers.load() > 0) {
+    { std::lock_guard<std::mutex> lock(sleep_mutex); }
+    wake.notify_one();
+  }
+}
+
+bool ThreadPoolState::FindWork(size_t queue, WorkItem *item) {
+  if (queues[queue]->PopBack(item)) {
+    pending.fetch_sub(1);
+    return true;
+  }
+
+  for (size_t i = 1; i < queues.size(); i++) {
+    if (queues[(queue + i) % queues.size()]->StealFront(item)) {
+      pending.fetch_sub(1);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPoolState::Execute(size_t queue, WorkItem item) {
+  while (item.end - item.begin > item.job->grain) {
+    size_t middle = item.begin + (item.end - item.begin) / 2;
+    Push(queue, WorkItem{item.job, middle, item.end});
+    item.end = middle;
+  }
+
+  ParallelJob *job = item.job;
+  job->function(job->context, item.begin, item.end);
+  job->remaining.fetch_sub(item.end - item.begin, std::memory_order_acq_rel);  // job may be gone after this
+}
+
+void ThreadPoolState::RunWorker(size_t queue) {
+  current_pool = this;
+  current_queue = queue;
+
+  WorkItem item{nullptr, 0, 0};
+  while (true) {
+    if (FindWork(queue, &item)) {
+      Execute(queue, item);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex);
+    sleepers.fetch_add(1);
+    wake.wait(lock, [this]() { return stop || pending.load() > 0; });
+    sleepers.fetch_sub(1);
+    if (stop) return;
+  }
+}
+
+size_t ThreadPoolState::CurrentQueue() const {
+  return (current_pool == this) ? current_queue : queues.size() - 1;
+}
+
+}  // namespace internal
+
+ThreadPool::ThreadPool()
+    : ThreadPool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0) {}
+
+ThreadPool::ThreadPool(size_t num_threads)
+    : state_(new internal::ThreadPoolState) {
+  for (size_t i = 0; i <= num_threads; i++) {
+    state_->queues.emplace_back(new internal::WorkQueue);
+  }
+  for (size_t i = 0; i < num_threads; i++) {
+    state_->threads.emplace_back(&internal::ThreadPoolState::RunWorker, state_, i);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(state_->sleep_mutex);
+    state_->stop = true;
+  }
+  state_->wake.notify_all();
+
+  for (std::thread &thread : state_->threads) thread.join();
+  delete state_;
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t grain, RangeFunction function, void *context) {
+  if (0 == count) return;
+  if (0 == grain) grain = 1;
+
+  if (state_->threads.empty() || count <= grain) {
+    function(context, 0, count);
+    return;
+  }
+
+  internal::ParallelJob job{function, context, grain, {count}};
+  size_t queue = state_->CurrentQueue();
+  state_->Execute(queue, internal::WorkItem{&job, 0, count});
+
+  // Help with any work until all ranges of this job are done
+  internal::WorkItem item{nullptr, 0, 0};
+  while (job.remaining.load(std::memory_order_acquire) > 0) {
+    if (state_->FindWork(queue, &item)) {
+      state_->Execute(queue, item);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+size_t ThreadPool::CountThreads() const {
+  return state_->threads.size();
+}
+
+} // namespace sigcxx
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2017 - 2018 The WizTK Authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sigcxx/timer_wheel.hpp"
+
+namespace sigcxx {
+
+Timer::~Timer() {
+  Stop();
+}
+
+void Timer::Start(TimerWheel &wheel, uint64_t ticks) {
+  Stop();
+
+  wheel_ = &wheel;
+  ticks_ = ticks;
+  expires_ = wheel.now_ + (ticks > 0 ? ticks : 1);
+  wheel.Place(this);
+  wheel.count_++;
+}
+
+void Timer::Restart() {
+  _ASSERT(nullptr != wheel_);
+  Start(*wheel_, ticks_);
+}
+
+void Timer::Stop() {
+  if (!IsActive()) return;
+
+  Unlink();
+  wheel_->count_--;
+}
+
+// ------
+
+constexpr int TimerWheel::kLevels;
+constexpr int TimerWheel::kFirstBits;
+constexpr int TimerWheel::kLevelBits;
+constexpr uint64_t TimerWheel::kFirstSize;
+constexpr uint64_t TimerWheel::kLevelSize;
+
+TimerWheel::TimerWheel(Clock::duration tick)
+    : origin_(Clock::now()), tick_(tick) {}
+
+TimerWheel::~TimerWheel() {
+  _ASSERT(!advancing_);
+
+  for (int level = 0; level < kLevels; level++) {
+    uint64_t size = (0 == level) ? kFirstSize : kLevelSize;
+    for (uint64_t i = 0; i < size; i++) {
+      internal::TimerNode *slot = SlotAt(level, i);
+      while (!slot->empty()) slot->next->Unlink();
+    }
+  }
+  count_ = 0;
+}
+
+size_t TimerWheel::Advance(uint64_t ticks) {
+  _ASSERT(!advancing_);
+  size_t fired = 0;
+
+  advancing_ = true;
+  for (uint64_t i = 0; i < ticks; i++) {
+    if (0 == count_) {  // nothing to move or expire
+      now_ += ticks - i;
+      break;
+    }
+
+    now_++;
+    uint64_t index = now_ & (kFirstSize - 1);
+    if (0 == index) {
+      for (int level = 1; level < kLevels; level++) {
+        if (0 != Cascade(level)) break;
+      }
+    }
+
+    first_[index].MoveTo(&expired_);
+    while (!expired_.empty()) {
+      auto *timer = static_cast<Timer *>(expired_.next);
+      timer->Unlink();
+      count_--;
+      fired++;
+      timer->timeout_.Emit();  // may start, stop or destroy any timer
+    }
+  }
+  advancing_ = false;
+
+  return fired;
+}
+
+size_t TimerWheel::Poll(Clock::time_point now) {
+  if (now <= origin_) return 0;
+
+  uint64_t tick = static_cast<uint64_t>((now - origin_) / tick_);
+  return (tick > now_) ? Advance(tick - now_) : 0;
+}
+
+void TimerWheel::Place(Timer *timer) {
+  uint64_t expires = timer->expires_ > now_ ? timer->expires_ : now_;
+  uint64_t delta = expires - now_;
+
+  if (delta < kFirstSize) {
+    first_[expires & (kFirstSize - 1)].PushBack(timer);
+    return;
+  }
+
+  int level = 1;
+  int shift = kFirstBits;
+  while ((level < kLevels - 1) && (delta >= (kFirstSize << ((level) * kLevelBits)))) {
+    level++;
+    shift += kLevelBits;
+  }
+
+  // Beyond the last level: park in its farthest slot, placed again later
+  uint64_t max_delta = (kFirstSize << ((kLevels - 1) * kLevelBits)) - 1;
+  if (delta > max_delta) expires = now_ + max_delta;
+
+  SlotAt(level, (expires >> shift) & (kLevelSize - 1))->PushBack(timer);
+}
+
+uint64_t TimerWheel::Cascade(int level) {
+  uint64_t index = (now_ >> (kFirstBits + (level - 1) * kLevelBits)) & (kLevelSize - 1);
+
+  internal::TimerNode list;
+  SlotAt(level, index)->MoveTo(&list);
+  while (!list.empty()) {
+    auto *timer = static_cast<Timer *>(list.next);
+    timer->Unlink();
+    Place(timer);
+  }
+
+  return index;
+}
+
+} // namespace sigcxx
@@ -3,6 +3,26 @@
 #include "test.hpp"
 
 #include <observer.hpp>
+#include <sigcxx/concurrent_signal.hpp>
+#include <sigcxx/event_loop.hpp>
+#include <sigcxx/thread_pool.hpp>
+#include <sigcxx/timer_wheel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
 #ifdef USE_BOOST_SIGNALS
 #include <boost/signals2.hpp>
@@ -10,6 +30,57 @@
 
 #define TEST_CYCLE_NUM 10000000
 
+// Updated by operator new in all threads of the benchmarks
+static std::atomic<size_t> heap_allocations(0);
+static std::atomic<size_t> heap_bytes(0);
+
+/*
+ * Replace the global operator new and delete as a pair to count allocations.
+ * The blocks are allocated and freed in one helper each, kept out of line so
+ * that the compiler does not see free() called on a pointer from new.
+ */
+#if defined(__GNUC__)
+#define BENCH_NOINLINE __attribute__((noinline))
+#else
+#define BENCH_NOINLINE
+#endif
+
+BENCH_NOINLINE static void *CountedAllocate(size_t size) {
+  heap_allocations.fetch_add(1, std::memory_order_relaxed);
+  heap_bytes.fetch_add(size, std::memory_order_relaxed);
+  void *p = std::malloc(size);
+  if (nullptr == p) throw std::bad_alloc();
+  return p;
+}
+
+BENCH_NOINLINE static void CountedFree(void *p) noexcept {
+  std::free(p);
+}
+
+void *operator new(size_t size) {
+  return CountedAllocate(size);
+}
+
+void *operator new[](size_t size) {
+  return CountedAllocate(size);
+}
+
+void operator delete(void *p) noexcept {
+  CountedFree(p);
+}
+
+void operator delete[](void *p) noexcept {
+  CountedFree(p);
+}
+
+void operator delete(void *p, size_t /* size */) noexcept {
+  CountedFree(p);
+}
+
+void operator delete[](void *p, size_t /* size */) noexcept {
+  CountedFree(p);
+}
+
 Test::Test()
     : testing::Test()
 {
@@ -50,6 +121,534 @@ TEST_F(Test, connect_many_events)
   ASSERT_TRUE(consumer.test0_count() == 0);
 }
 
+#define BENCH_SLOT_NUM 64
+#define BENCH_EMIT_NUM 100000
+
+/*
+ * Cycle counter for the per-slot benchmarks, falls back to nanoseconds on
+ * other architectures.
+ */
+static inline uint64_t ReadCycles() {
+#if defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#else
+  return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/*
+ * Per-slot cost of Signal::Emit() with 1, 4 and 64 connections, the slot
+ * method only increases a counter so the cost is dominated by the dispatch.
+ */
+TEST_F(Test, per_slot_cycles) {
+  const int slot_nums[] = {1, 4, BENCH_SLOT_NUM};
+  Observer consumer;
+  size_t total = 0;
+
+  for (int slot_num : slot_nums) {
+    sigcxx::Signal<> event;
+    for (int i = 0; i < slot_num; i++) {
+      event.Connect(&consumer, &Observer::OnTest0);
+    }
+
+    uint64_t start = ReadCycles();
+    for (int i = 0; i < BENCH_EMIT_NUM; i++) {
+      event();
+    }
+    uint64_t end = ReadCycles();
+    total += static_cast<size_t>(BENCH_EMIT_NUM) * slot_num;
+
+    std::cout << "Per-slot cycles, Signal::Emit() with " << slot_num << " slots: "
+              << static_cast<double>(end - start) / (BENCH_EMIT_NUM * slot_num) << std::endl;
+  }
+
+  ASSERT_TRUE(consumer.test0_count() == total);
+}
+
+/*
+ * Memory used by a signal and the cost of emitting it with 0, 1, 4 and 64
+ * connections. The bytes are the signal object, the node pool blocks and any
+ * heap memory taken by the connections, measured after the pool has a slab
+ * for the size class.
+ */
+TEST_F(Test, footprint_and_emission) {
+  const int connection_nums[] = {0, 1, 4, 64};
+
+  std::cout << "sizeof(Signal<>): " << sizeof(sigcxx::Signal<>) << std::endl;
+
+  for (int num : connection_nums) {
+    Observer consumer;
+    sigcxx::Signal<> event;
+
+    {
+      sigcxx::Signal<> warm_up;
+      warm_up.Connect(&consumer, &Observer::OnTest0);
+    }
+
+    size_t allocations = heap_allocations;
+    size_t bytes = heap_bytes;
+    ptrdiff_t pool_bytes = sigcxx::internal::NodePool::CountThreadBytes();
+    for (int i = 0; i < num; i++) {
+      event.Connect(&consumer, &Observer::OnTest0);
+    }
+    allocations = heap_allocations - allocations;
+    bytes = heap_bytes - bytes;
+    pool_bytes = sigcxx::internal::NodePool::CountThreadBytes() - pool_bytes;
+
+    uint64_t start = ReadCycles();
+    for (int i = 0; i < BENCH_EMIT_NUM; i++) {
+      event();
+    }
+    uint64_t end = ReadCycles();
+
+    size_t total_bytes = sizeof(event) + bytes + static_cast<size_t>(pool_bytes);
+    std::cout << num << " connection(s): " << allocations << " heap allocation(s), "
+              << total_bytes << " bytes";
+    if (num > 0) std::cout << " (" << (total_bytes - sizeof(event)) / num << " per connection)";
+    std::cout << ", "
+              << static_cast<double>(end - start) / BENCH_EMIT_NUM << " cycles per Emit()" << std::endl;
+
+    ASSERT_TRUE(consumer.test0_count() == static_cast<size_t>(num) * BENCH_EMIT_NUM);
+    if (num <= 1) {
+      ASSERT_TRUE(allocations == 0);
+    }
+  }
+}
+
+/*
+ * Emit a chain of 6 signals with a slot at the end of each one.
+ */
+TEST_F(Test, chained_emission) {
+  const int depth = 6;
+  Observer consumer;
+  sigcxx::Signal<> chain[depth];
+
+  for (int i = 0; i < depth; i++) {
+    chain[i].Connect(&consumer, &Observer::OnTest0);
+    if (i + 1 < depth) chain[i].Connect(chain[i + 1]);
+  }
+
+  uint64_t start = ReadCycles();
+  for (int i = 0; i < BENCH_EMIT_NUM; i++) {
+    chain[0]();
+  }
+  uint64_t end = ReadCycles();
+
+  std::cout << "Chain of " << depth << " signals: "
+            << static_cast<double>(end - start) / BENCH_EMIT_NUM << " cycles per Emit()" << std::endl;
+
+  ASSERT_TRUE(consumer.test0_count() == static_cast<size_t>(depth) * BENCH_EMIT_NUM);
+}
+
+/*
+ * Look up and disconnect each observer of a signal with 10000 connections.
+ */
+TEST_F(Test, lookup_many_observers) {
+  const int num = 10000;
+  std::vector<Observer> observers(num);
+  sigcxx::Signal<int> signal;
+
+  for (Observer &o : observers) signal.Connect(&o, &Observer::OnTest1IntegerParam);
+
+  int count = 0;
+  uint64_t start = ReadCycles();
+  for (Observer &o : observers) count += signal.CountConnections(&o, &Observer::OnTest1IntegerParam);
+  uint64_t end = ReadCycles();
+
+  std::cout << "CountConnections() of " << num << " connections: "
+            << static_cast<double>(end - start) / num << " cycles per call" << std::endl;
+
+  start = ReadCycles();
+  for (Observer &o : observers) signal.DisconnectAll(&o, &Observer::OnTest1IntegerParam);
+  end = ReadCycles();
+
+  std::cout << "DisconnectAll() of " << num << " connections: "
+            << static_cast<double>(end - start) / num << " cycles per call" << std::endl;
+
+  ASSERT_TRUE(count == num && signal.CountConnections() == 0);
+}
+
+/*
+ * Connect 1000 observers and disconnect them in a random order, by method
+ * and by the Connection handle.
+ */
+TEST_F(Test, connection_churn) {
+  const int num = 1000;
+  std::vector<Observer> observers(num);
+  std::vector<int> order(num);
+  for (int i = 0; i < num; i++) order[i] = (i * 7919) % num;
+
+  sigcxx::Signal<int> signal;
+
+  uint64_t start = ReadCycles();
+  for (Observer &o : observers) signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  for (int i : order) signal.Disconnect(&observers[i], &Observer::OnTest1IntegerParam);
+  uint64_t end = ReadCycles();
+
+  std::cout << "Connect() and Disconnect() by method: "
+            << static_cast<double>(end - start) / num << " cycles per connection" << std::endl;
+
+  std::vector<sigcxx::Connection> connections;
+  connections.reserve(num);
+
+  start = ReadCycles();
+  for (Observer &o : observers) connections.push_back(signal.Connect(&o, &Observer::OnTest1IntegerParam));
+  for (int i : order) connections[i].Disconnect();
+  end = ReadCycles();
+
+  std::cout << "Connect() and Connection::Disconnect(): "
+            << static_cast<double>(end - start) / num << " cycles per connection" << std::endl;
+
+  ASSERT_TRUE(signal.CountConnections() == 0);
+}
+
+/*
+ * Destroy an observer connected 8 times to each of 1000 signals, the
+ * connections are torn down by Trackable::UnbindAllSignals().
+ */
+TEST_F(Test, unbind_all_signals) {
+  const int num = 1000;
+  const int repeat = 8;
+  std::unique_ptr<sigcxx::Signal<int>[]> signals(new sigcxx::Signal<int>[num]);
+  auto *observer = new Observer;
+
+  for (int i = 0; i < repeat; i++) {
+    for (int j = 0; j < num; j++) signals[j].Connect(observer, &Observer::OnTest1IntegerParam);
+  }
+
+  uint64_t start = ReadCycles();
+  delete observer;
+  uint64_t end = ReadCycles();
+
+  std::cout << "UnbindAllSignals() of " << num * repeat << " connections: "
+            << static_cast<double>(end - start) / (num * repeat) << " cycles per connection" << std::endl;
+
+  for (int i = 0; i < num; i++) ASSERT_TRUE(signals[i].empty());
+}
+
+/*
+ * Disconnect all 10000 connections of a signal at once.
+ */
+TEST_F(Test, disconnect_all_connections) {
+  const int num = 10000;
+  std::vector<Observer> observers(num);
+  sigcxx::Signal<int> signal;
+
+  for (Observer &o : observers) signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  signal.Connect(&observers[0], &Observer::OnTest1IntegerParam, num / 2);  // builds the position index
+
+  uint64_t start = ReadCycles();
+  signal.DisconnectAll();
+  uint64_t end = ReadCycles();
+
+  std::cout << "DisconnectAll() of " << num + 1 << " connections: "
+            << static_cast<double>(end - start) / (num + 1) << " cycles per connection" << std::endl;
+
+  ASSERT_TRUE(signal.empty());
+}
+
+/*
+ * Connect 4 observers, emit and disconnect them in a loop, the same pattern
+ * as the thread_safe test. Run in 1 and 4 threads, each with its own signal.
+ */
+static void ConnectDisconnectLoop(int loops) {
+  Observer observers[4];
+  sigcxx::Signal<int> signal;
+
+  for (int i = 0; i < loops; i++) {
+    for (Observer &o : observers) signal.Connect(&o, &Observer::OnTest1IntegerParam);
+    signal(i);
+    signal.DisconnectAll();
+  }
+}
+
+TEST_F(Test, connect_disconnect_throughput) {
+  const int loops = 200000;
+
+  size_t allocations = heap_allocations;
+  auto start = std::chrono::steady_clock::now();
+  ConnectDisconnectLoop(loops);
+  auto end = std::chrono::steady_clock::now();
+  allocations = heap_allocations - allocations;
+
+  double ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << "1 thread: " << static_cast<double>(allocations) / loops << " allocation(s) and "
+            << ns / (loops * 4) << " ns per connect and disconnect" << std::endl;
+
+  start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) threads.emplace_back(ConnectDisconnectLoop, loops);
+  for (std::thread &t : threads) t.join();
+  end = std::chrono::steady_clock::now();
+
+  ns = std::chrono::duration<double, std::nano>(end - start).count();
+  std::cout << "4 threads: " << ns / (loops * 4) << " ns per 4 connects and disconnects" << std::endl;
+}
+
+/*
+ * Emit a signal with 4 connections from 1, 2 and 4 threads at the same time:
+ * a ConcurrentSignal, and a Signal behind a mutex as in the thread_safe test.
+ */
+template<typename EmitFunction>
+static double MeasureEmitThreads(int num_threads, int loops, EmitFunction emit) {
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num_threads; i++) {
+    threads.emplace_back([loops, &emit]() {
+      for (int j = 0; j < loops; j++) emit(j);
+    });
+  }
+  for (std::thread &t : threads) t.join();
+  auto end = std::chrono::steady_clock::now();
+
+  // Emissions per microsecond of all threads
+  return num_threads * loops / std::chrono::duration<double, std::micro>(end - start).count();
+}
+
+TEST_F(Test, concurrent_emit_scaling) {
+  const int loops = 1000000;
+  Observer observers[4];
+  sigcxx::ConcurrentSignal<int> concurrent;
+  sigcxx::Signal<int> locked;
+  std::mutex mutex;
+
+  for (Observer &o : observers) {
+    concurrent.Connect(&o, &Observer::OnTest1IntegerParam);
+    locked.Connect(&o, &Observer::OnTest1IntegerParam);
+  }
+
+  std::cout << std::thread::hardware_concurrency() << " hardware thread(s)" << std::endl;
+  for (int num_threads : {1, 2, 4}) {
+    double lock_free = MeasureEmitThreads(num_threads, loops, [&concurrent](int n) { concurrent(n); });
+    double with_mutex = MeasureEmitThreads(num_threads, loops, [&locked, &mutex](int n) {
+      std::lock_guard<std::mutex> lock(mutex);
+      locked(n);
+    });
+    std::cout << num_threads << " thread(s): ConcurrentSignal " << lock_free
+              << ", Signal with a mutex " << with_mutex << " emissions per us" << std::endl;
+  }
+}
+
+
+/*
+ * Emit a queued connection and run the tasks in batches of 1000, the tasks
+ * come from the node pool and do not hit the heap once it's warm.
+ */
+TEST_F(Test, queued_emission) {
+  const int batches = 1000;
+  const int batch_size = 1000;
+  sigcxx::TaskQueue queue;
+  Observer observer;
+  sigcxx::Signal<int> signal;
+
+  signal.Connect(&observer, &Observer::OnTest1IntegerParam, queue);
+  for (int j = 0; j < batch_size; j++) signal(j);  // warm up the node pool
+  queue.RunPending();
+
+  size_t allocations = heap_allocations;
+  uint64_t start = ReadCycles();
+  for (int i = 0; i < batches; i++) {
+    for (int j = 0; j < batch_size; j++) signal(j);
+    queue.RunPending();
+  }
+  uint64_t end = ReadCycles();
+  allocations = heap_allocations - allocations;
+
+  std::cout << "Queued connection: " << static_cast<double>(end - start) / (batches * batch_size)
+            << " cycles per Emit() and call, " << allocations << " heap allocation(s)" << std::endl;
+
+  ASSERT_TRUE(observer.test1_count() == static_cast<size_t>((batches + 1) * batch_size));
+}
+
+/*
+ * The same as queued_emission with a coalescing connection: a batch of 1000
+ * emissions leaves one task in queue and allocates nothing.
+ */
+TEST_F(Test, coalesced_emission) {
+  const int batches = 1000;
+  const int batch_size = 1000;
+  sigcxx::TaskQueue queue;
+  Observer observer;
+  sigcxx::Signal<int> signal;
+
+  signal.ConnectCoalesced(&observer, &Observer::OnTest1IntegerParam, queue);
+
+  size_t allocations = heap_allocations;
+  size_t tasks = 0;
+  uint64_t start = ReadCycles();
+  for (int i = 0; i < batches; i++) {
+    for (int j = 0; j < batch_size; j++) signal(j);
+    tasks += queue.RunPending();
+  }
+  uint64_t end = ReadCycles();
+  allocations = heap_allocations - allocations;
+
+  std::cout << "Coalesced connection: " << static_cast<double>(end - start) / (batches * batch_size)
+            << " cycles per Emit(), " << tasks << " call(s), " << allocations << " heap allocation(s)" << std::endl;
+
+  ASSERT_TRUE(tasks == static_cast<size_t>(batches) && observer.test1_count() == static_cast<size_t>(batches));
+}
+
+/*
+ * 100000 per-connection timeouts: start them, restart each one 10 times as
+ * if there was traffic, stop half of them and let the rest expire.
+ */
+TEST_F(Test, timer_wheel_churn) {
+  const int num = 100000;
+  const int restarts = 10;
+  sigcxx::TimerWheel wheel;
+  Observer observer;
+  std::unique_ptr<sigcxx::Timer[]> timers(new sigcxx::Timer[num]);
+
+  for (int i = 0; i < num; i++) timers[i].timeout().Connect(&observer, &Observer::OnTest0);
+
+  size_t allocations = heap_allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < num; i++) timers[i].Start(wheel, 30000 + i % 1000);
+  for (int r = 0; r < restarts; r++) {
+    wheel.Advance(100);
+    for (int i = 0; i < num; i++) timers[i].Restart();
+  }
+  for (int i = 0; i < num; i += 2) timers[i].Stop();
+  auto middle = std::chrono::steady_clock::now();
+  size_t fired = wheel.Advance(40000);
+  auto end = std::chrono::steady_clock::now();
+  allocations = heap_allocations - allocations;
+
+  std::cout << "Timer wheel: " << std::chrono::duration<double, std::nano>(middle - start).count() / (num * (restarts + 1.5))
+            << " ns per start, restart or stop, "
+            << std::chrono::duration<double, std::nano>(end - middle).count() / fired
+            << " ns per expiry, " << allocations << " heap allocation(s)" << std::endl;
+
+  ASSERT_TRUE(fired == static_cast<size_t>(num / 2) && observer.test0_count() == static_cast<size_t>(num / 2));
+}
+
+class LatencyProbe : public sigcxx::Trackable {
+ public:
+
+  void OnPosted(int64_t posted, sigcxx::SLOT /* slot */) {
+    int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    total_ns_ += now - posted;
+    count_++;
+  }
+
+  int64_t total_ns_ = 0;
+  int count_ = 0;
+};
+
+static int64_t NowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*
+ * Post queued emissions to an EventLoop from 1 and 4 threads while it runs,
+ * then measure the time from Emit() to the call when the loop is asleep.
+ */
+TEST_F(Test, event_loop_throughput_and_latency) {
+  const int loops = 200000;
+
+  for (int num_threads : {1, 4}) {
+    sigcxx::EventLoop loop;
+    Observer observer;
+    std::vector<std::unique_ptr<sigcxx::Signal<int>>> signals;
+
+    for (int i = 0; i < num_threads; i++) {
+      signals.emplace_back(new sigcxx::Signal<int>);
+      signals.back()->Connect(&observer, &Observer::OnTest1IntegerParam, loop);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int i = 0; i < num_threads; i++) {
+      sigcxx::Signal<int> *signal = signals[i].get();
+      threads.emplace_back([signal, loops]() {
+        for (int j = 0; j < loops; j++) (*signal)(j);
+      });
+    }
+    while (observer.test1_count() < static_cast<size_t>(num_threads * loops)) loop.RunOnce();
+    auto end = std::chrono::steady_clock::now();
+    for (std::thread &t : threads) t.join();
+
+    std::cout << num_threads << " posting thread(s): "
+              << num_threads * loops / std::chrono::duration<double, std::micro>(end - start).count()
+              << " queued calls per us" << std::endl;
+  }
+
+  const int samples = 200;
+  sigcxx::EventLoop loop;
+  LatencyProbe probe;
+  sigcxx::Signal<int64_t> signal;
+  signal.Connect(&probe, &LatencyProbe::OnPosted, loop);
+
+  std::thread poster([&signal, &loop]() {
+    for (int i = 0; i < samples; i++) {
+      std::this_thread::sleep_for(std::chrono::microseconds(200));
+      signal(NowNs());
+    }
+    loop.Quit();
+  });
+  loop.Run();
+  poster.join();
+  loop.Drain();
+
+  std::cout << "Wake-up latency: " << probe.total_ns_ / 1000.0 / probe.count_ << " us from Emit() to call"
+            << std::endl;
+  ASSERT_TRUE(probe.count_ == samples);
+}
+
+class Worker : public sigcxx::Trackable {
+ public:
+
+  void OnWork(int n, sigcxx::SLOT /* slot */) {
+    uint64_t x = static_cast<uint64_t>(n) + result_;
+    for (int i = 0; i < 256; i++) x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    result_ = x;
+  }
+
+  uint64_t result_ = 0;
+};
+
+/*
+ * Emit a signal with 10000 connections doing some work each by Emit(), and
+ * by EmitParallel() on pools of 0 to N - 1 workers. The speedup is bounded by
+ * the hardware threads printed first.
+ */
+TEST_F(Test, emit_parallel_scaling) {
+  const int num = 10000;
+  const int loops = 100;
+  std::vector<std::unique_ptr<Worker>> workers;
+  sigcxx::Signal<int> signal;
+
+  for (int i = 0; i < num; i++) {
+    workers.emplace_back(new Worker);
+    signal.Connect(workers.back().get(), &Worker::OnWork);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  for (int j = 0; j < loops; j++) signal.Emit(j);
+  auto end = std::chrono::steady_clock::now();
+  double serial = std::chrono::duration<double, std::micro>(end - start).count() / loops;
+
+  size_t hardware = std::thread::hardware_concurrency();
+  std::cout << hardware << " hardware thread(s), Emit(): " << serial << " us per emission" << std::endl;
+
+  for (size_t num_threads = 1; num_threads <= std::max<size_t>(hardware, 4); num_threads *= 2) {
+    sigcxx::ThreadPool pool(num_threads - 1);
+    start = std::chrono::steady_clock::now();
+    for (int j = 0; j < loops; j++) signal.EmitParallel(pool, j);
+    end = std::chrono::steady_clock::now();
+
+    double parallel = std::chrono::duration<double, std::micro>(end - start).count() / loops;
+    std::cout << num_threads << " thread(s): EmitParallel() " << parallel << " us per emission, "
+              << serial / parallel << "x" << std::endl;
+  }
+
+  ASSERT_TRUE(signal.CountConnections() == num);
+}
+
 #ifdef USE_BOOST_SIGNALS
 
 struct Simple
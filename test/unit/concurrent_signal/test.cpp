@@ -0,0 +1,283 @@
+// Unit test code for ConcurrentSignal
+
+#include "test.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnCount(int n, SLOT /* slot */) {
+    sum_ += n;
+    count_++;
+  }
+
+  void OnDisconnectOther(int /* n */, SLOT /* slot */) {
+    count_++;
+    if (nullptr != other_) other_->Disconnect();
+  }
+
+  std::atomic<int> sum_{0};
+  std::atomic<int> count_{0};
+  Connection *other_ = nullptr;
+};
+
+/**
+ * @brief An observer whose slot method uses its members for a while
+ */
+class SlowConsumer : public Trackable {
+ public:
+
+  explicit SlowConsumer(std::atomic<int> *errors)
+      : errors_(errors) {}
+
+  ~SlowConsumer() override {
+    UnbindAllSignals();  // wait for the calls in progress before alive_ is cleared
+    alive_ = false;
+  }
+
+  void OnCall(int /* n */, SLOT /* slot */) {
+    for (int i = 0; i < 100; i++) {
+      if (!alive_) (*errors_)++;
+      std::this_thread::yield();
+    }
+  }
+
+  void OnDeleteThis(int /* n */, SLOT /* slot */) {
+    delete this;
+  }
+
+  std::atomic<bool> alive_{true};
+  std::atomic<int> *errors_;
+};
+
+/**
+ * @brief An observer which disconnects itself when called in its own thread
+ */
+class SelfDisconnecting : public Trackable {
+ public:
+
+  SelfDisconnecting() = default;
+
+  void OnCall(int /* n */, SLOT /* slot */) {
+    count_++;
+    if (std::this_thread::get_id() != owner_) return;
+    // Give the other thread time to be in its own slot method
+    for (int i = 0; i < 10; i++) std::this_thread::yield();
+    UnbindAllSignals();
+  }
+
+  std::thread::id owner_;
+  std::atomic<int> count_{0};
+};
+
+/*
+ * Connect, emit, disconnect and auto-disconnect in one thread
+ */
+TEST_F(Test, connect_and_disconnect) {
+  ConcurrentSignal<int> signal;
+  Consumer c1;
+  auto *c2 = new Consumer;
+
+  Connection connection = signal.Connect(&c1, &Consumer::OnCount);
+  signal.Connect(&c1, &Consumer::OnCount);
+  signal.Connect(c2, &Consumer::OnCount);
+
+  signal(1);
+  ASSERT_TRUE(c1.sum_ == 2 && c2->sum_ == 1 && signal.CountConnections() == 3 &&
+      signal.IsConnectedTo(&c1, &Consumer::OnCount) && c1.CountSignalBindings() == 2);
+
+  delete c2;
+  connection.Disconnect();
+  signal(1);
+  ASSERT_TRUE(c1.sum_ == 3 && signal.CountConnections() == 1 && c1.CountSignalBindings() == 1);
+
+  signal.DisconnectAll(&c1, &Consumer::OnCount);
+  signal(1);
+  ASSERT_TRUE(c1.sum_ == 3 && signal.empty() && c1.CountSignalBindings() == 0);
+}
+
+/*
+ * Blocked signals and connections are not called
+ */
+TEST_F(Test, block) {
+  ConcurrentSignal<int> signal;
+  Consumer c1;
+  Consumer c2;
+
+  Connection connection = signal.Connect(&c1, &Consumer::OnCount);
+  signal.Connect(&c2, &Consumer::OnCount);
+
+  connection.Block();
+  signal(1);
+  {
+    SignalBlocker blocker(signal);
+    signal(1);
+  }
+  connection.Unblock();
+  signal(1);
+
+  ASSERT_TRUE(c1.count_ == 1 && c2.count_ == 2);
+}
+
+/*
+ * A connection broken in a slot method is skipped in the same emission
+ */
+TEST_F(Test, disconnect_on_fire) {
+  ConcurrentSignal<int> signal;
+  Consumer c1;
+  Consumer c2;
+
+  signal.Connect(&c1, &Consumer::OnDisconnectOther);
+  Connection connection = signal.Connect(&c2, &Consumer::OnCount);
+  c1.other_ = &connection;
+
+  signal(1);
+  signal(1);
+
+  ASSERT_TRUE(c1.count_ == 2 && c2.count_ == 0 && signal.CountConnections() == 1);
+}
+
+/*
+ * Emit in several threads while other connections are made and broken
+ */
+TEST_F(Test, emit_while_connecting) {
+  const int num = 4;
+  const int loops = 10000;
+  ConcurrentSignal<int> signal;
+  Consumer c;
+  Consumer other;
+  std::atomic<bool> done{false};
+
+  signal.Connect(&c, &Consumer::OnCount);
+
+  std::vector<std::thread> emitters;
+  for (int i = 0; i < num; i++) {
+    emitters.emplace_back([&signal]() {
+      for (int j = 0; j < loops; j++) signal(1);
+    });
+  }
+
+  std::thread writer([&signal, &other, &done]() {
+    while (!done) {
+      Connection connection = signal.Connect(&other, &Consumer::OnCount);
+      signal.Connect(&other, &Consumer::OnCount);
+      connection.Disconnect();
+      signal.DisconnectAll(&other, &Consumer::OnCount);
+    }
+  });
+
+  for (std::thread &t : emitters) t.join();
+  done = true;
+  writer.join();
+
+  ASSERT_TRUE(c.count_ == num * loops && signal.CountConnections() == 1);
+}
+
+/*
+ * Old snapshots are freed when no thread is emitting
+ */
+TEST_F(Test, reclaim_snapshots) {
+  {
+    ConcurrentSignal<int> signal;
+    Consumer c;
+    for (int i = 0; i < 100; i++) signal.Connect(&c, &Consumer::OnCount);
+    signal(1);
+  }
+
+  internal::EpochDomain::Collect();
+  ASSERT_TRUE(internal::EpochDomain::CountRetired() == 0);
+}
+
+/*
+ * Destroying an observer waits for the calls to it in other threads, and
+ * emissions started later skip it
+ */
+TEST_F(Test, destroy_while_emitting) {
+  const int num = 3;
+  const int loops = 200;
+  ConcurrentSignal<int> signal;
+  Consumer c;
+  std::atomic<int> errors{0};
+  std::atomic<bool> done{false};
+
+  signal.Connect(&c, &Consumer::OnCount);
+
+  std::vector<std::thread> emitters;
+  for (int i = 0; i < num; i++) {
+    emitters.emplace_back([&signal, &done]() {
+      while (!done) signal(1);
+    });
+  }
+
+  for (int i = 0; i < loops; i++) {
+    auto *observer = new SlowConsumer(&errors);
+    signal.Connect(observer, &SlowConsumer::OnCall);
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    delete observer;
+  }
+
+  done = true;
+  for (std::thread &t : emitters) t.join();
+
+  ASSERT_TRUE(errors == 0 && signal.CountConnections() == 1);
+}
+
+/*
+ * A slot method can destroy its own observer
+ */
+TEST_F(Test, delete_in_slot) {
+  ConcurrentSignal<int> signal;
+  Consumer c;
+  std::atomic<int> errors{0};
+
+  signal.Connect(new SlowConsumer(&errors), &SlowConsumer::OnDeleteThis);
+  signal.Connect(&c, &Consumer::OnCount);
+  signal(1);
+  signal(1);
+
+  ASSERT_TRUE(errors == 0 && c.count_ == 2 && signal.CountConnections() == 1);
+}
+
+/*
+ * Two threads emit the same signal and each disconnects its own observer in
+ * the slot method, neither waits for the other
+ */
+TEST_F(Test, self_disconnect_in_two_threads) {
+  const int loops = 2000;
+  ConcurrentSignal<int> signal;
+  SelfDisconnecting observers[2];
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 2; i++) {
+    threads.emplace_back([&signal, &observers, i]() {
+      SelfDisconnecting &observer = observers[i];
+      observer.owner_ = std::this_thread::get_id();
+      for (int j = 0; j < loops; j++) {
+        signal.Connect(&observer, &SelfDisconnecting::OnCall);
+        while (observer.CountSignalBindings() > 0) signal(1);
+      }
+    });
+  }
+
+  for (std::thread &t : threads) t.join();
+
+  ASSERT_TRUE(signal.empty() && observers[0].count_ >= loops && observers[1].count_ >= loops);
+}
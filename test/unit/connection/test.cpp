@@ -0,0 +1,148 @@
+// Unit test code for Connection and ScopedConnection
+
+#include "test.hpp"
+
+#include <sigcxx/flat_signal.hpp>
+#include <sigcxx/static_signal.hpp>
+
+#include <utility>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(int n, SLOT /* slot */) {
+    record_.push_back(n);
+  }
+
+  void OnDisconnectSelf(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    connection_.Disconnect();
+  }
+
+  std::vector<int> record_;
+  Connection connection_;
+};
+
+/*
+ * Disconnect() only breaks the connection it was returned for
+ */
+TEST_F(Test, disconnect) {
+  Signal<int> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnRecord);
+  Connection connection = signal.Connect(&c, &Consumer::OnRecord);
+  signal.Connect(&c, &Consumer::OnRecord);
+
+  ASSERT_TRUE(connection.IsConnected() && signal.CountConnections() == 3);
+
+  connection.Disconnect();
+  ASSERT_TRUE(!connection && signal.CountConnections() == 2 && c.CountSignalBindings() == 2);
+
+  connection.Disconnect();
+  ASSERT_TRUE(signal.CountConnections() == 2);
+}
+
+/*
+ * The handle is cleared when the connection is broken in other ways
+ */
+TEST_F(Test, cleared_on_removal) {
+  auto *signal = new Signal<int>;
+  Signal<int> chained;
+  auto *c = new Consumer;
+
+  Connection c1 = signal->Connect(c, &Consumer::OnRecord);
+  Connection c2 = signal->Connect(chained);
+  Connection c3 = chained.Connect(c, &Consumer::OnRecord);
+
+  delete c;
+  ASSERT_TRUE(c1.IsConnected() == false && c3.IsConnected() == false && c2.IsConnected());
+
+  delete signal;
+  ASSERT_TRUE(c2.IsConnected() == false && chained.CountSignalBindings() == 0);
+}
+
+/*
+ * A handle can be moved, and destroying it keeps the connection
+ */
+TEST_F(Test, move) {
+  Signal<int> signal;
+  Consumer c;
+
+  std::vector<Connection> connections;
+  for (int i = 0; i < 10; i++) {
+    connections.push_back(signal.Connect(&c, &Consumer::OnRecord));
+  }
+
+  Connection connection;
+  connection = std::move(connections[5]);
+  ASSERT_TRUE(connection.IsConnected() && !connections[5].IsConnected());
+
+  connections.clear();
+  ASSERT_TRUE(signal.CountConnections() == 10);
+
+  connection.Disconnect();
+  ASSERT_TRUE(signal.CountConnections() == 9);
+}
+
+/*
+ * ScopedConnection breaks the connection when destroyed, unless released
+ */
+TEST_F(Test, scoped_connection) {
+  Signal<int> signal;
+  FlatSignal<int> flat;
+  StaticSignal<2, int> static_signal;
+  Consumer c;
+  Connection released;
+
+  {
+    ScopedConnection s1 = signal.Connect(&c, &Consumer::OnRecord);
+    ScopedConnection s2 = flat.Connect(&c, &Consumer::OnRecord);
+    ScopedConnection s3 = static_signal.Connect(&c, &Consumer::OnRecord);
+    ScopedConnection s4 = signal.Connect(&c, &Consumer::OnRecord);
+    released = s4.Release();
+
+    signal(1);
+    flat(2);
+    static_signal(3);
+  }
+
+  signal(4);
+  flat(5);
+  static_signal(6);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1, 1, 2, 3, 4}) && released.IsConnected() &&
+      signal.CountConnections() == 1 && flat.CountConnections() == 0 && static_signal.CountConnections() == 0);
+}
+
+/*
+ * A connection can be broken by its handle in the slot method
+ */
+TEST_F(Test, disconnect_on_fire) {
+  Signal<int> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnRecord);
+  c.connection_ = signal.Connect(&c, &Consumer::OnDisconnectSelf);
+  signal.Connect(&c, &Consumer::OnRecord);
+
+  signal(1);
+  signal(2);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1, 1, 1, 2, 2}) && signal.CountConnections() == 2);
+}
@@ -14,11 +14,13 @@ Test::~Test() {
 
 }
 
+#if defined(__GXX_RTTI) || defined(_CPPRTTI)
 TEST_F(Test, rtti) {
   TestClassBase obj;
 
   ASSERT_TRUE(typeid(&obj) == typeid(TestClassBase *));
 }
+#endif
 
 /*
  *
@@ -63,6 +63,22 @@ class Consumer : public sigcxx::Trackable {
     UnbindAllSignalsTo(&Consumer::OnTestDisconnectAll);
   }
 
+  void OnTestCount(int /* n */, SLOT /* slot */) {
+    count_++;
+  }
+
+  void OnTestDisconnectCount(int /* n */, SLOT slot) {
+    count_++;
+    slot->signal<int>()->DisconnectAll(this, &Consumer::OnTestCount);
+  }
+
+  void OnTestEmitAgain(int n, SLOT slot) {
+    count_++;
+    if (n == 0) slot->signal<int>()->Emit(1);
+  }
+
+  int count_ = 0;
+
 };
 
 /*
@@ -141,3 +157,33 @@ TEST_F(Test, disconnect_all_on_fire1) {
   s.DoTest();
   ASSERT_TRUE(c.CountSignalBindings() == 1);
 }
+
+/*
+ * Disconnect the connections after the current one
+ */
+TEST_F(Test, disconnect_next_on_fire) {
+  Source s;
+  Consumer c;
+
+  s.event().Connect(&c, &Consumer::OnTestDisconnectCount);
+  s.event().Connect(&c, &Consumer::OnTestCount);
+  s.event().Connect(&c, &Consumer::OnTestCount);
+
+  s.DoTest();
+  ASSERT_TRUE(c.count_ == 1 && c.CountSignalBindings() == 1);
+}
+
+/*
+ * Disconnect in a nested emission of the same signal
+ */
+TEST_F(Test, disconnect_in_nested_emission) {
+  Source s;
+  Consumer c;
+
+  s.event().Connect(&c, &Consumer::OnTestEmitAgain);
+  s.event().Connect(&c, &Consumer::OnTestDisconnectCount);
+  s.event().Connect(&c, &Consumer::OnTestCount);
+
+  s.DoTest();
+  ASSERT_TRUE(c.count_ == 4 && s.event().CountConnections() == 2);
+}
@@ -0,0 +1,139 @@
+// Unit test code for Signal::EmitParallel
+
+#include "test.hpp"
+
+#include <sigcxx/thread_pool.hpp>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnCount(int n, SLOT /* slot */) {
+    count_ += n;
+  }
+
+  void OnCountOnce(int n, SLOT slot) {
+    count_ += n;
+    UnbindSignal(slot);
+  }
+
+  std::atomic<int> count_{0};
+};
+
+static void AddRange(void *context, size_t begin, size_t end) {
+  auto *sum = static_cast<std::atomic<size_t> *>(context);
+  for (size_t i = begin; i < end; i++) *sum += i;
+}
+
+struct NestedLoop {
+  ThreadPool *pool;
+  std::atomic<size_t> sum{0};
+};
+
+static void RunNested(void *context, size_t begin, size_t end) {
+  auto *loop = static_cast<NestedLoop *>(context);
+  for (size_t i = begin; i < end; i++) loop->pool->ParallelFor(100, 10, AddRange, &loop->sum);
+}
+
+/*
+ * Every index is run once, including in nested loops
+ */
+TEST_F(Test, parallel_for) {
+  ThreadPool pool(3);
+  std::atomic<size_t> sum{0};
+
+  pool.ParallelFor(10000, 16, AddRange, &sum);
+  ASSERT_TRUE(sum == 10000 * 9999 / 2);
+
+  NestedLoop loop;
+  loop.pool = &pool;
+  pool.ParallelFor(64, 1, RunNested, &loop);
+  ASSERT_TRUE(loop.sum == 64 * (100 * 99 / 2));
+}
+
+/*
+ * All connections not blocked are called once, including the ones of chained
+ * signals
+ */
+TEST_F(Test, all_slots_called) {
+  const int num = 1000;
+  ThreadPool pool(3);
+  Signal<int> signal;
+  Signal<int> chained;
+  Signal<int> blocked;
+  std::vector<std::unique_ptr<Consumer>> consumers;
+
+  for (int i = 0; i < num; i++) {
+    consumers.emplace_back(new Consumer);
+    Signal<int> &target = (i % 3 == 0) ? chained : ((i % 3 == 1) ? signal : blocked);
+    target.Connect(consumers.back().get(), &Consumer::OnCount);
+  }
+  signal.Connect(chained);
+  signal.Connect(blocked).Block();
+  Connection connection = signal.Connect(consumers[1].get(), &Consumer::OnCount);
+  connection.Block();
+
+  signal.EmitParallel(pool, 1);
+
+  for (int i = 0; i < num; i++) {
+    ASSERT_TRUE(consumers[i]->count_ == ((i % 3 == 2) ? 0 : 1));
+  }
+}
+
+/*
+ * Connections unbound in slot methods are removed after all are called
+ */
+TEST_F(Test, unbind_in_slot) {
+  const int num = 1000;
+  ThreadPool pool(3);
+  Signal<int> signal;
+  Signal<int> chained;
+  std::vector<std::unique_ptr<Consumer>> consumers;
+
+  for (int i = 0; i < num; i++) {
+    consumers.emplace_back(new Consumer);
+    Signal<int> &target = (i % 2 == 0) ? chained : signal;
+    target.Connect(consumers.back().get(), &Consumer::OnCountOnce);
+    target.Connect(consumers.back().get(), &Consumer::OnCount);
+  }
+  signal.Connect(chained);
+
+  signal.EmitParallel(pool, 1);
+  ASSERT_TRUE(signal.CountConnections() == num / 2 + 1 && chained.CountConnections() == num / 2);
+
+  signal.EmitParallel(pool, 1);
+  for (int i = 0; i < num; i++) {
+    ASSERT_TRUE(consumers[i]->count_ == 3 && consumers[i]->CountSignalBindings() == 1);
+  }
+}
+
+/*
+ * A pool without worker threads calls all slot methods in this thread
+ */
+TEST_F(Test, no_worker_threads) {
+  ThreadPool pool(0);
+  Signal<int> signal;
+  Consumer c;
+
+  for (int i = 0; i < 200; i++) signal.Connect(&c, &Consumer::OnCountOnce);
+  signal.EmitParallel(pool, 2);
+
+  ASSERT_TRUE(pool.CountThreads() == 0 && c.count_ == 400 && signal.empty());
+}
@@ -0,0 +1,185 @@
+// Unit test code for EventLoop
+
+#include "test.hpp"
+
+#include <sigcxx/event_loop.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  explicit Consumer(EventLoop *loop = nullptr)
+      : loop_(loop) {}
+
+  virtual ~Consumer() {}
+
+  void OnCount(int n, SLOT /* slot */) {
+    sum_ += n;
+    count_++;
+  }
+
+  void OnQuit(int n, SLOT /* slot */) {
+    sum_ += n;
+    loop_->Quit();
+  }
+
+  void OnCountAndQuit(int n, SLOT /* slot */) {
+    sum_ += n;
+    if (++count_ == 100) loop_->Quit();
+  }
+
+  EventLoop *loop_;
+  int sum_ = 0;
+  int count_ = 0;
+};
+
+/*
+ * Drain() runs at most the given number of tasks
+ */
+TEST_F(Test, drain) {
+  EventLoop loop;
+  Signal<int> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnCount, loop);
+  for (int i = 0; i < 10; i++) signal(1);
+
+  ASSERT_TRUE(loop.Drain(4) == 4 && c.count_ == 4);
+  ASSERT_TRUE(loop.RunOnce() == 6 && c.count_ == 10);
+  ASSERT_TRUE(loop.Drain() == 0);
+}
+
+/*
+ * Quit() in a slot method ends Run() and is cleared for the next one
+ */
+TEST_F(Test, quit_in_slot) {
+  EventLoop loop;
+  Signal<int> signal;
+  Consumer c(&loop);
+
+  signal.Connect(&c, &Consumer::OnQuit, loop);
+  signal(1);
+  loop.Run();
+  ASSERT_TRUE(c.sum_ == 1);
+
+  signal(2);
+  loop.Run();
+  ASSERT_TRUE(c.sum_ == 3);
+}
+
+/*
+ * RunOnce() returns 0 for a Quit() and clears it, the next call waits for a
+ * task again
+ */
+TEST_F(Test, quit_run_once) {
+  EventLoop loop;
+  Signal<int> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnCount, loop);
+  loop.Quit();
+  ASSERT_TRUE(loop.RunOnce() == 0);
+
+  std::thread thread([&signal]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    signal(1);
+  });
+
+  ASSERT_TRUE(loop.RunOnce() == 1 && c.sum_ == 1);
+  thread.join();
+}
+
+/*
+ * Quit() in a slot method ends Run() even if another thread keeps posting
+ * and the queue is never empty
+ */
+TEST_F(Test, quit_while_posting) {
+  EventLoop loop;
+  Signal<int> signal;
+  Consumer c(&loop);
+  std::atomic<bool> stop{false};
+
+  signal.Connect(&c, &Consumer::OnCountAndQuit, loop);
+  for (int i = 0; i < 1000; i++) signal(1);
+
+  std::thread thread([&signal, &stop]() {
+    while (!stop.load()) signal(1);
+  });
+
+  loop.Run();
+  stop.store(true);
+  thread.join();
+
+  ASSERT_TRUE(c.count_ == 100);
+}
+
+/*
+ * A sleeping loop is woken up by Post() and Quit() from another thread
+ */
+TEST_F(Test, wake_up) {
+  EventLoop loop;
+  Signal<int> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnCount, loop);
+
+  std::thread thread([&signal, &loop]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    signal(1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    loop.Quit();
+  });
+
+  ASSERT_TRUE(loop.RunOnce() == 1 && c.sum_ == 1);
+  loop.Run();
+  thread.join();
+
+  ASSERT_TRUE(c.sum_ == 1);
+}
+
+/*
+ * Tasks posted by many threads are all run in the loop thread
+ */
+TEST_F(Test, post_from_threads) {
+  const int num = 4;
+  const int loops = 10000;
+  EventLoop loop;
+  Consumer c(&loop);
+  Signal<int> quit;
+  std::vector<Signal<int> *> signals;
+  std::atomic<int> finished{0};
+
+  quit.Connect(&c, &Consumer::OnQuit, loop);
+  for (int i = 0; i < num; i++) {
+    signals.push_back(new Signal<int>);
+    signals.back()->Connect(&c, &Consumer::OnCount, loop);
+  }
+
+  std::vector<std::thread> threads;
+  for (Signal<int> *signal : signals) {
+    threads.emplace_back([signal, &quit, &finished]() {
+      for (int j = 0; j < loops; j++) (*signal)(1);
+      if (++finished == num) quit(0);
+    });
+  }
+
+  loop.Run();
+  for (std::thread &t : threads) t.join();
+  for (Signal<int> *signal : signals) delete signal;
+
+  ASSERT_TRUE(c.count_ == num * loops && c.sum_ == num * loops);
+}
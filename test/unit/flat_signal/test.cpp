@@ -0,0 +1,304 @@
+// Unit test code for FlatSignal
+
+#include "test.hpp"
+
+#include <observer.hpp>
+
+#include <sigcxx/flat_signal.hpp>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(int n, SLOT /* slot */) {
+    record_.push_back(n);
+  }
+
+  void OnUnbind(int n, SLOT slot) {
+    record_.push_back(n);
+    UnbindSignal(slot);
+  }
+
+  void OnUnbindAll(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    UnbindAllSignals();
+  }
+
+  void OnConnectFront(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    signal_->Connect(this, &Consumer::OnRecord, 0);
+  }
+
+  void OnConnectMany(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    signal_->Disconnect(this, &Consumer::OnConnectMany);
+    for (int i = 0; i < 64; i++) signal_->Connect(this, &Consumer::OnRecord);
+  }
+
+  void OnDeleteSignal(int /* n */, SLOT /* slot */) {
+    delete signal_;
+  }
+
+  void OnDestroy(int /* n */, SLOT /* slot */) {
+    delete this;
+  }
+
+  std::vector<int> record_;
+  FlatSignal<int> *signal_ = nullptr;
+};
+
+/*
+ *
+ */
+TEST_F(Test, connect_method_4_times) {
+  FlatSignal<int> signal;
+  Observer o;
+
+  signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o, &Observer::OnTest1IntegerParam);
+
+  signal(1);
+
+  ASSERT_TRUE(o.test1_count() == 4 &&
+      signal.CountConnections() == 4 &&
+      signal.CountConnections(&o, &Observer::OnTest1IntegerParam) == 4 &&
+      o.CountSignalBindings() == 4);
+}
+
+/*
+ * Connect by index follows the same rule as Signal
+ */
+TEST_F(Test, connect_by_index) {
+  FlatSignal<int> flat;
+  Signal<int> signal;
+  Consumer c1;
+  Consumer c2;
+
+  int index[] = {-1, 0, -1, 1, -2, 10, -10, 3};
+  int count = sizeof(index) / sizeof(int);
+  for (int i = 0; i < count; i++) {
+    flat.Connect(&c1, &Consumer::OnRecord, index[i]);
+    signal.Connect(&c2, &Consumer::OnRecord, index[i]);
+  }
+
+  for (int i = 0; i < count; i++) {
+    flat.Disconnect(i);
+    signal.Disconnect(i);
+    flat(i);
+    signal(i);
+  }
+
+  ASSERT_TRUE(c1.record_ == c2.record_ && flat.CountConnections() == signal.CountConnections());
+}
+
+/*
+ *
+ */
+TEST_F(Test, disconnect_by_position) {
+  FlatSignal<int> signal;
+  Observer o1;
+  Observer o2;
+
+  signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o2, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o2, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+
+  int count1 = signal.Disconnect(&o1, &Observer::OnTest1IntegerParam, 1, 1);  // the 3rd
+  int count2 = signal.Disconnect(&o2, &Observer::OnTest1IntegerParam, -2, 1);  // the 4th
+
+  signal(1);
+
+  ASSERT_TRUE(count1 == 1 && count2 == 1 &&
+      o1.test1_count() == 2 && o2.test1_count() == 1 &&
+      o1.CountSignalBindings() == 2 && o2.CountSignalBindings() == 1);
+}
+
+/*
+ *
+ */
+TEST_F(Test, disconnect_all) {
+  FlatSignal<int> signal;
+  Observer o1;
+  Observer o2;
+
+  signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o2, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+
+  signal.DisconnectAll(&o1, &Observer::OnTest1IntegerParam);
+  signal(1);
+
+  ASSERT_TRUE(!signal.IsConnectedTo(&o1, &Observer::OnTest1IntegerParam) &&
+      signal.IsConnectedTo(&o2) &&
+      o1.test1_count() == 0 && o2.test1_count() == 1);
+
+  signal.DisconnectAll();
+
+  ASSERT_TRUE(signal.CountConnections() == 0 && o2.CountSignalBindings() == 0);
+}
+
+/*
+ * Destroy the observer and the connection is removed automatically
+ */
+TEST_F(Test, auto_disconnect) {
+  FlatSignal<int> signal;
+  Observer o1;
+  auto *o2 = new Observer;
+
+  signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+  signal.Connect(o2, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+
+  delete o2;
+  signal(1);
+
+  ASSERT_TRUE(signal.CountConnections() == 2 && o1.test1_count() == 2);
+
+  {
+    FlatSignal<int> tmp;
+    tmp.Connect(&o1, &Observer::OnTest1IntegerParam);
+  }
+
+  ASSERT_TRUE(o1.CountSignalBindings() == 2);
+}
+
+/*
+ *
+ */
+TEST_F(Test, chaining) {
+  FlatSignal<int> signal1;
+  auto *signal2 = new FlatSignal<int>;
+  Observer o;
+
+  signal1.Connect(*signal2);
+  signal2->Connect(&o, &Observer::OnTest1IntegerParam);
+
+  signal1(1);
+
+  ASSERT_TRUE(signal1.IsConnectedTo(*signal2) && signal1.CountConnections(*signal2) == 1 &&
+      o.test1_count() == 1);
+
+  delete signal2;
+
+  ASSERT_TRUE(signal1.CountConnections() == 0 && o.CountSignalBindings() == 0);
+}
+
+/*
+ *
+ */
+TEST_F(Test, unbind_on_fire) {
+  FlatSignal<int> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnRecord);
+  signal.Connect(&c, &Consumer::OnUnbind);
+  signal.Connect(&c, &Consumer::OnRecord);
+  signal.Connect(&c, &Consumer::OnUnbind);
+
+  signal(1);
+  signal(2);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1, 1, 1, 1, 2, 2}) &&
+      c.CountSignalBindings() == 2 && signal.CountConnections() == 2);
+}
+
+/*
+ *
+ */
+TEST_F(Test, unbind_all_on_fire) {
+  FlatSignal<int> signal;
+  Consumer c1;
+  Consumer c2;
+
+  signal.Connect(&c1, &Consumer::OnRecord);
+  signal.Connect(&c2, &Consumer::OnUnbindAll);
+  signal.Connect(&c2, &Consumer::OnRecord);
+  signal.Connect(&c1, &Consumer::OnRecord);
+
+  signal(1);
+
+  ASSERT_TRUE((c1.record_ == std::vector<int>{1, 1}) &&
+      (c2.record_ == std::vector<int>{1}) &&
+      signal.CountConnections() == 2);
+}
+
+/*
+ * Connections added while emitting are called in the same emission only if
+ * they are after the current one.
+ */
+TEST_F(Test, connect_on_fire) {
+  FlatSignal<int> signal;
+  Consumer c;
+  c.signal_ = &signal;
+
+  signal.Connect(&c, &Consumer::OnConnectFront);
+  signal(1);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1}) && signal.CountConnections() == 2);
+}
+
+/*
+ * A slot method which removes itself and makes the array reallocated still
+ * returns to the right position
+ */
+TEST_F(Test, reallocate_on_fire) {
+  FlatSignal<int> signal;
+  Consumer c;
+  c.signal_ = &signal;
+
+  signal.Connect(&c, &Consumer::OnConnectMany);
+  signal.Connect(&c, &Consumer::OnRecord);
+  signal(1);
+
+  ASSERT_TRUE(c.record_.size() == 1 + 1 + 64 && signal.CountConnections() == 1 + 64);
+}
+
+/*
+ *
+ */
+TEST_F(Test, delete_observer_on_fire) {
+  FlatSignal<int> signal;
+  Consumer c;
+  auto *obj = new Consumer;
+
+  signal.Connect(&c, &Consumer::OnRecord);
+  signal.Connect(obj, &Consumer::OnDestroy);
+  signal.Connect(&c, &Consumer::OnRecord);
+
+  signal(1);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1, 1}) && signal.CountConnections() == 2);
+}
+
+/*
+ *
+ */
+TEST_F(Test, delete_signal_on_fire) {
+  Consumer c;
+  c.signal_ = new FlatSignal<int>;
+
+  c.signal_->Connect(&c, &Consumer::OnRecord);
+  c.signal_->Connect(&c, &Consumer::OnDeleteSignal);
+  c.signal_->Connect(&c, &Consumer::OnRecord);
+
+  c.signal_->Emit(1);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1}) && c.CountSignalBindings() == 0);
+}
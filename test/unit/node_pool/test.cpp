@@ -0,0 +1,116 @@
+// Unit test code for the node pool of tokens and bindings
+
+#include "test.hpp"
+
+#include <observer.hpp>
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace sigcxx;
+
+static std::atomic<size_t> allocate_count(0);
+static std::atomic<size_t> deallocate_count(0);
+
+static void *CountedAllocate(size_t size) {
+  allocate_count++;
+  return std::malloc(size);
+}
+
+static void CountedDeallocate(void *p, size_t /* size */) {
+  deallocate_count++;
+  std::free(p);
+}
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+/*
+ * The custom allocator gives slabs to the pool, and freed nodes are reused
+ */
+TEST_F(Test, custom_allocator) {
+  ASSERT_TRUE(SetNodeAllocator(NodeAllocator{CountedAllocate, CountedDeallocate}));
+
+  Signal<int> signal;
+  std::vector<Observer> observers(100);
+
+  for (Observer &o : observers) signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  size_t count = allocate_count;
+  ASSERT_TRUE(count > 0 && count < 100);
+
+  for (int i = 0; i < 100; i++) {
+    signal.DisconnectAll();
+    for (Observer &o : observers) signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  }
+  signal(1);
+
+  ASSERT_TRUE(allocate_count == count && deallocate_count == 0 && observers[0].test1_count() == 1);
+
+  // The pool is in use, the allocator cannot be changed any more
+  ASSERT_TRUE(!SetNodeAllocator(NodeAllocator{CountedAllocate, CountedDeallocate}));
+}
+
+/*
+ * The slabs taken by a burst of connections are returned to the allocator
+ * when the connections are removed
+ */
+TEST_F(Test, release_slabs) {
+  SetNodeAllocator(NodeAllocator{CountedAllocate, CountedDeallocate});  // if run alone
+
+  size_t allocated = allocate_count;
+  size_t released = deallocate_count;
+
+  {
+    Signal<int> signal;
+    std::vector<Observer> observers(10000);
+    for (Observer &o : observers) signal.Connect(&o, &Observer::OnTest1IntegerParam);
+    allocated = allocate_count - allocated;
+  }
+  released = deallocate_count - released;
+
+  // A few slabs stay for the magazine of this thread and the one kept empty
+  ASSERT_TRUE(allocated > 10 && released + 4 >= allocated);
+}
+
+/*
+ * Nodes can be allocated and freed in different threads
+ */
+TEST_F(Test, threads) {
+  const int num = 1000;
+  std::vector<Observer> observers(4 * num);  // num observers for each thread
+  std::vector<Signal<int> *> signals;
+
+  for (int i = 0; i < 4; i++) {
+    auto *signal = new Signal<int>;
+    for (int k = 0; k < num; k++) signal->Connect(&observers[i * num + k], &Observer::OnTest1IntegerParam);
+    signals.push_back(signal);
+  }
+
+  // Free the nodes in other threads and connect again there, each thread
+  // changes only its own signal and observers
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&observers, &signals, i]() {
+      for (int j = 0; j < 10; j++) {
+        signals[i]->DisconnectAll();
+        for (int k = 0; k < num; k += 2) signals[i]->Connect(&observers[i * num + k], &Observer::OnTest1IntegerParam);
+      }
+    });
+  }
+  for (std::thread &t : threads) t.join();
+
+  size_t count = 0;
+  for (Signal<int> *signal : signals) count += signal->CountConnections();
+
+  // Free the nodes allocated in other threads here
+  for (Signal<int> *signal : signals) delete signal;
+
+  ASSERT_TRUE(count == 4 * num / 2 && observers[0].CountSignalBindings() == 0);
+}
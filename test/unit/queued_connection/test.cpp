@@ -0,0 +1,219 @@
+// Unit test code for queued connections
+
+#include "test.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(const std::string &str, SLOT slot) {
+    record_.push_back(str);
+    if (nullptr != slot) record_.push_back("slot");
+  }
+
+  void OnCount(int n, SLOT /* slot */) {
+    sum_ += n;
+    calls_++;
+  }
+
+  std::vector<std::string> record_;
+  std::atomic<int> sum_{0};
+  std::atomic<int> calls_{0};
+};
+
+class Progress : public Trackable {
+ public:
+
+  void OnProgress(int value, SLOT /* slot */) {
+    values_.push_back(value);
+  }
+
+  static void Add(std::tuple<int> *pending, int value) {
+    std::get<0>(*pending) += value;
+  }
+
+  std::vector<int> values_;
+};
+
+/*
+ * A queued slot method is called with a copy of the arguments when the
+ * executor runs the tasks
+ */
+TEST_F(Test, queued_call) {
+  TaskQueue queue;
+  Signal<const std::string &> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnRecord, queue);
+  signal.Connect(&c, &Consumer::OnRecord);
+
+  std::string str("a");
+  signal(str);
+  str = "b";
+  signal(str);
+  ASSERT_TRUE((c.record_ == std::vector<std::string>{"a", "slot", "b", "slot"}));
+
+  ASSERT_TRUE(queue.RunPending() == 2 && queue.RunPending() == 0);
+  ASSERT_TRUE((c.record_ == std::vector<std::string>{"a", "slot", "b", "slot", "a", "b"}));
+  ASSERT_TRUE(signal.IsConnectedTo(&c, &Consumer::OnRecord) && signal.CountConnections(&c, &Consumer::OnRecord) == 2);
+}
+
+/*
+ * Calls in queue are skipped after the connection is removed
+ */
+TEST_F(Test, cancel_on_disconnect) {
+  TaskQueue queue;
+  Signal<int> signal;
+  Consumer c1;
+  auto *c2 = new Consumer;
+
+  Connection connection = signal.Connect(&c1, &Consumer::OnCount, queue);
+  signal.Connect(c2, &Consumer::OnCount, queue);
+
+  signal(1);
+  signal(1);
+  connection.Disconnect();
+  delete c2;
+  signal(1);
+
+  ASSERT_TRUE(queue.RunPending() == 4 && c1.sum_ == 0 && signal.empty());
+}
+
+/*
+ * Tasks not run are freed with the queue
+ */
+TEST_F(Test, discard_tasks) {
+  Signal<const std::string &> signal;
+  Consumer c;
+
+  {
+    TaskQueue queue;
+    signal.Connect(&c, &Consumer::OnRecord, queue);
+    signal(std::string(100, 'a'));
+    signal.DisconnectAll();
+  }
+
+  ASSERT_TRUE(c.record_.empty());
+}
+
+/*
+ * Signals emitted in several threads post to the queue of one thread
+ */
+TEST_F(Test, post_from_threads) {
+  const int num = 4;
+  const int loops = 10000;
+  TaskQueue queue;
+  Consumer c;
+  std::vector<Signal<int> *> signals;
+
+  for (int i = 0; i < num; i++) {
+    signals.push_back(new Signal<int>);
+    signals.back()->Connect(&c, &Consumer::OnCount, queue);
+  }
+
+  std::vector<std::thread> threads;
+  for (Signal<int> *signal : signals) {
+    threads.emplace_back([signal]() {
+      for (int j = 0; j < loops; j++) (*signal)(1);
+    });
+  }
+
+  while (c.sum_ < num * loops) {
+    if (queue.RunPending() == 0) std::this_thread::yield();
+  }
+
+  for (std::thread &t : threads) t.join();
+  for (Signal<int> *signal : signals) delete signal;
+
+  ASSERT_TRUE(c.sum_ == num * loops && queue.RunPending() == 0 && c.CountSignalBindings() == 0);
+}
+
+/*
+ * Emissions pending in a coalescing connection keep the latest arguments,
+ * or are merged by the merge function
+ */
+TEST_F(Test, coalesce) {
+  TaskQueue queue;
+  Signal<int> signal;
+  Progress latest;
+  Progress merged;
+
+  signal.ConnectCoalesced(&latest, &Progress::OnProgress, queue);
+  signal.ConnectCoalesced(&merged, &Progress::OnProgress, queue, &Progress::Add);
+
+  for (int i = 1; i <= 100; i++) signal(i);
+  ASSERT_TRUE(queue.RunPending() == 2);
+  signal(7);
+  ASSERT_TRUE(queue.RunPending() == 2 && queue.RunPending() == 0);
+
+  ASSERT_TRUE((latest.values_ == std::vector<int>{100, 7}));
+  ASSERT_TRUE((merged.values_ == std::vector<int>{5050, 7}));
+  ASSERT_TRUE(signal.IsConnectedTo(&latest, &Progress::OnProgress) && signal.CountConnections() == 2);
+
+  signal(1);
+  signal.DisconnectAll(&merged, &Progress::OnProgress);
+  ASSERT_TRUE(queue.RunPending() == 2 && latest.values_.size() == 3 && merged.values_.size() == 2);
+}
+
+/*
+ * A pending call is freed with the queue after the observer is destroyed
+ */
+TEST_F(Test, coalesce_discard) {
+  Signal<const std::string &> signal;
+  auto *c = new Consumer;
+
+  {
+    TaskQueue queue;
+    signal.ConnectCoalesced(c, &Consumer::OnRecord, queue);
+    signal(std::string(100, 'a'));
+    signal(std::string(100, 'b'));
+    delete c;
+  }
+
+  ASSERT_TRUE(signal.empty());
+}
+
+/*
+ * A fast producer thread leaves at most one call in queue
+ */
+TEST_F(Test, coalesce_from_thread) {
+  const int loops = 100000;
+  TaskQueue queue;
+  Signal<int> signal;
+  Consumer c;
+
+  signal.ConnectCoalesced(&c, &Consumer::OnCount, queue, [](std::tuple<int> *pending, int n) {
+    std::get<0>(*pending) += n;
+  });
+
+  std::atomic<bool> done{false};
+  std::thread producer([&signal, &done]() {
+    for (int j = 0; j < loops; j++) signal(1);
+    done = true;
+  });
+
+  size_t tasks = 0;
+  while (!done) tasks += queue.RunPending();
+  producer.join();
+  tasks += queue.RunPending();
+
+  ASSERT_TRUE(c.sum_ == loops && tasks == static_cast<size_t>(c.calls_) && c.calls_ <= loops);
+}
@@ -0,0 +1,260 @@
+// Unit test code for passing arguments from Emit() to slot methods
+
+#include "test.hpp"
+
+#include <sigcxx/flat_signal.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+/**
+ * @brief A payload which counts how many times it's copied
+ */
+class Payload {
+ public:
+
+  explicit Payload(int value)
+      : value_(value) {}
+
+  Payload(const Payload &other)
+      : value_(other.value_) {
+    copy_count_++;
+  }
+
+  Payload(Payload &&other) noexcept
+      : value_(other.value_) {}
+
+  Payload &operator=(const Payload &other) {
+    value_ = other.value_;
+    copy_count_++;
+    return *this;
+  }
+
+  int value() const { return value_; }
+
+  static int copy_count_;
+
+ private:
+
+  int value_;
+
+};
+
+int Payload::copy_count_ = 0;
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnValue(Payload payload, SLOT /* slot */) {
+    sum_ += payload.value();
+  }
+
+  void OnConstRef(const Payload &payload, SLOT /* slot */) {
+    sum_ += payload.value();
+  }
+
+  void OnRef(Payload &payload, SLOT /* slot */) {
+    sum_ += payload.value();
+    payload = Payload(payload.value() + 1);
+  }
+
+  void OnUniquePtr(const std::unique_ptr<int> &p, SLOT /* slot */) {
+    sum_ += *p;
+  }
+
+  void OnString(const std::string &str, SLOT /* slot */) {
+    strings_.push_back(str);
+  }
+
+  void OnTakeString(std::string str, SLOT /* slot */) {
+    strings_.push_back(std::move(str));
+  }
+
+  void OnUnbindAll(const Payload &payload, SLOT /* slot */) {
+    sum_ += payload.value();
+    UnbindAllSignalsTo(&Consumer::OnConstRef);
+  }
+
+  int sum_ = 0;
+  std::vector<std::string> strings_;
+};
+
+/*
+ * A slot method taking a const reference does not copy the argument
+ */
+TEST_F(Test, const_ref_no_copy) {
+  Signal<Payload> signal;
+  std::vector<Consumer> consumers(50);
+
+  for (Consumer &c : consumers) {
+    signal.Connect(&c, &Consumer::OnConstRef);
+  }
+
+  Payload payload(1);
+  Payload::copy_count_ = 0;
+  signal.Emit(std::move(payload));
+
+  int sum = 0;
+  for (Consumer &c : consumers) sum += c.sum_;
+
+  ASSERT_TRUE(Payload::copy_count_ == 0 && sum == 50);
+}
+
+/*
+ * A slot method taking the argument by value copies it once and only once
+ */
+TEST_F(Test, value_copy_once) {
+  Signal<Payload> signal;
+  std::vector<Consumer> consumers(50);
+
+  for (Consumer &c : consumers) {
+    signal.Connect(&c, &Consumer::OnValue);
+  }
+
+  Payload::copy_count_ = 0;
+  signal(Payload(1));
+
+  ASSERT_TRUE(Payload::copy_count_ == 50);
+}
+
+/*
+ * The argument is not copied when forwarded through chained signals
+ */
+TEST_F(Test, chain_no_copy) {
+  Signal<Payload> signal1;
+  Signal<Payload> signal2;
+  FlatSignal<Payload> signal3;
+  Consumer c1;
+  Consumer c2;
+
+  signal1.Connect(signal2);
+  signal2.Connect(&c1, &Consumer::OnConstRef);
+  signal2.Connect(&c2, &Consumer::OnConstRef);
+  signal3.Connect(&c1, &Consumer::OnConstRef);
+
+  Payload::copy_count_ = 0;
+  signal1(Payload(2));
+  signal3(Payload(3));
+
+  ASSERT_TRUE(Payload::copy_count_ == 0 && c1.sum_ == 5 && c2.sum_ == 2);
+}
+
+/*
+ * A slot method taking the argument by value gets its own copy, moving from
+ * it does not change the argument of the next slot methods
+ */
+TEST_F(Test, value_not_shared) {
+  Signal<std::string> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnTakeString);
+  signal.Connect(&c, &Consumer::OnString);
+  signal.Connect(&c, &Consumer::OnTakeString);
+  signal("hello");
+
+  ASSERT_TRUE((c.strings_ == std::vector<std::string>{"hello", "hello", "hello"}));
+}
+
+/*
+ * Only a non-const reference parameter lets slot methods change the object of
+ * the caller
+ */
+TEST_F(Test, mutable_ref) {
+  Signal<Payload &> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnRef);
+  signal.Connect(&c, &Consumer::OnRef);
+
+  Payload payload(1);
+  signal(payload);
+
+  ASSERT_TRUE(c.sum_ == 1 + 2 && payload.value() == 3);
+}
+
+/*
+ * A move-only type can be used as the parameter of a signal, slot methods
+ * take it by const reference as it cannot be copied or moved from
+ */
+TEST_F(Test, move_only) {
+  Signal<std::unique_ptr<int>> signal1;
+  Signal<std::unique_ptr<int>> signal2;
+  FlatSignal<std::unique_ptr<int>> signal3;
+  Consumer c;
+
+  signal1.Connect(&c, &Consumer::OnUniquePtr);
+  signal1.Connect(signal2);
+  signal2.Connect(&c, &Consumer::OnUniquePtr);
+  signal3.Connect(&c, &Consumer::OnUniquePtr);
+
+  signal1(std::unique_ptr<int>(new int(1)));
+  signal3.Emit(std::unique_ptr<int>(new int(10)));
+
+  ASSERT_TRUE(c.sum_ == 12);
+}
+
+/*
+ * Slot methods with different reference types can be connected, checked and
+ * disconnected
+ */
+TEST_F(Test, connect_compatible_slots) {
+  Signal<std::string> signal;
+  Signal<const std::string &> ref_signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnString);
+  signal.Connect(&c, &Consumer::OnString);
+  ref_signal.Connect(&c, &Consumer::OnString);
+
+  signal("hello");
+  ref_signal(std::string("world"));
+
+  ASSERT_TRUE(signal.IsConnectedTo(&c, &Consumer::OnString) &&
+      signal.CountConnections(&c, &Consumer::OnString) == 2 &&
+      c.CountSignalBindings(&Consumer::OnString) == 3 &&
+      (c.strings_ == std::vector<std::string>{"hello", "hello", "world"}));
+
+  signal.Disconnect(&c, &Consumer::OnString);
+  ASSERT_TRUE(signal.CountConnections() == 1);
+
+  signal.DisconnectAll(&c, &Consumer::OnString);
+  ASSERT_TRUE(signal.CountConnections() == 0 && c.CountSignalBindings() == 1);
+}
+
+/*
+ * Trackable::UnbindAllSignalsTo() works for slot methods taking references
+ * and for FlatSignal
+ */
+TEST_F(Test, unbind_all_signals_to) {
+  Signal<Payload> signal;
+  FlatSignal<Payload> flat;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnConstRef);
+  signal.Connect(&c, &Consumer::OnUnbindAll);
+  signal.Connect(&c, &Consumer::OnConstRef);
+  flat.Connect(&c, &Consumer::OnConstRef);
+  flat.Connect(&c, &Consumer::OnValue);
+
+  ASSERT_TRUE(c.CountSignalBindings(&Consumer::OnConstRef) == 3);
+
+  signal(Payload(1));
+
+  ASSERT_TRUE(c.sum_ == 2 && signal.CountConnections() == 1 && flat.CountConnections() == 1 &&
+      c.CountSignalBindings(&Consumer::OnConstRef) == 0);
+}
@@ -58,6 +58,23 @@ TEST_F(Test, push_back1) {
   ASSERT_TRUE(consumer.CountSignalBindings() == 3 && signal.CountConnections() == 3);
 }
 
+/*
+ * Pin the memory used by a signal and a connection, a token must not grow
+ * beyond the 96 bytes (on 64-bit) it used before the indexes, an observer
+ * is its vtable and bindings, and an unconnected signal fits in two cache
+ * lines
+ */
+TEST_F(Test, footprint) {
+  ASSERT_TRUE(sizeof(Trackable) <= 5 * sizeof(void *));
+  ASSERT_TRUE(sizeof(internal::DelegateToken<SLOT>) <= 12 * sizeof(void *));
+  ASSERT_TRUE(sizeof(internal::SignalTokenNode) <= 12 * sizeof(void *));
+  ASSERT_TRUE(sizeof(Signal<>) <= 13 * sizeof(void *) && sizeof(Signal<>) <= 128);
+
+  std::cout << "sizeof(Trackable): " << sizeof(Trackable)
+            << ", sizeof(Signal<>): " << sizeof(Signal<>)
+            << ", sizeof(DelegateToken): " << sizeof(internal::DelegateToken<SLOT>) << std::endl;
+}
+
 //TEST_F(Test, copy_observer)
 //{
 //  Source s;
@@ -0,0 +1,212 @@
+// Unit test code for blocking signals and connections
+
+#include "test.hpp"
+
+#include <sigcxx/flat_signal.hpp>
+
+#include <tuple>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(int n, SLOT /* slot */) {
+    record_.push_back(n);
+  }
+
+  void OnBlockOther(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    other_->Block();
+  }
+
+  void OnBatch(std::tuple<int> *tuples, size_t count, SLOT /* slot */) {
+    for (size_t i = 0; i < count; i++) record_.push_back(std::get<0>(tuples[i]));
+  }
+
+  std::vector<int> record_;
+  Connection *other_ = nullptr;
+};
+
+/*
+ * A blocked signal calls no slot method and keeps its connections
+ */
+TEST_F(Test, block_signal) {
+  Signal<int> signal;
+  Consumer c;
+
+  signal.Connect(&c, &Consumer::OnRecord);
+  signal.Connect(&c, &Consumer::OnRecord);
+
+  signal.Block();
+  signal(1);
+  ASSERT_TRUE(signal.IsBlocked() && c.record_.empty() && signal.CountConnections() == 2);
+
+  signal.Unblock();
+  signal(2);
+  ASSERT_TRUE(!signal.IsBlocked() && (c.record_ == std::vector<int>{2, 2}));
+}
+
+/*
+ * A blocked chained signal is skipped when the upstream signal is emitted
+ */
+TEST_F(Test, block_chained_signal) {
+  Signal<int> s0;
+  Signal<int> s1;
+  Signal<int> s2;
+  Consumer c;
+
+  s0.Connect(&c, &Consumer::OnRecord);
+  s0.Connect(s1);
+  s1.Connect(&c, &Consumer::OnRecord);
+  s1.Connect(s2);
+  s2.Connect(&c, &Consumer::OnRecord);
+
+  s0(0);
+  s2.Block();
+  s0(1);
+  s1.Block();
+  s0(2);
+  s1.Unblock();
+  s2.Unblock();
+  s0(3);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{0, 0, 0, 1, 1, 2, 3, 3, 3}));
+}
+
+/*
+ * A blocked connection is skipped and keeps its position
+ */
+TEST_F(Test, block_connection) {
+  Signal<int> s0;
+  Signal<int> s1;
+  Consumer c1;
+  Consumer c2;
+
+  Connection connection = s0.Connect(&c1, &Consumer::OnRecord);
+  s0.Connect(&c2, &Consumer::OnRecord);
+  Connection chain = s0.Connect(s1);
+  s1.Connect(&c2, &Consumer::OnRecord);
+
+  connection.Block();
+  chain.Block();
+  s0(1);
+  ASSERT_TRUE(connection.IsBlocked() && c1.record_.empty() && (c2.record_ == std::vector<int>{1}));
+
+  connection.Unblock();
+  chain.Unblock();
+  s0(2);
+  ASSERT_TRUE((c1.record_ == std::vector<int>{2}) && (c2.record_ == std::vector<int>{1, 2, 2}) &&
+      s0.CountConnections() == 3);
+
+  connection.Disconnect();
+  connection.Block();
+  ASSERT_TRUE(!connection.IsBlocked());
+}
+
+/*
+ * A connection blocked in a slot method is skipped in the same emission
+ */
+TEST_F(Test, block_on_fire) {
+  Signal<int> signal;
+  Consumer c1;
+  Consumer c2;
+
+  signal.Connect(&c1, &Consumer::OnBlockOther);
+  Connection connection = signal.Connect(&c2, &Consumer::OnRecord);
+  c1.other_ = &connection;
+
+  signal(1);
+
+  ASSERT_TRUE((c1.record_ == std::vector<int>{1}) && c2.record_.empty());
+}
+
+/*
+ * EmitBatch() skips blocked connections and blocked signals
+ */
+TEST_F(Test, block_batch) {
+  Signal<int> signal;
+  Consumer c1;
+  Consumer c2;
+
+  Connection connection = signal.ConnectBatch(&c1, &Consumer::OnBatch);
+  signal.Connect(&c2, &Consumer::OnRecord);
+
+  std::tuple<int> tuples[] = {std::make_tuple(1), std::make_tuple(2)};
+  connection.Block();
+  signal.EmitBatch(tuples, 2);
+  signal.Block();
+  signal.EmitBatch(tuples, 2);
+
+  ASSERT_TRUE(c1.record_.empty() && (c2.record_ == std::vector<int>{1, 2}));
+}
+
+/*
+ * FlatSignal and its connections can be blocked as well
+ */
+TEST_F(Test, block_flat_signal) {
+  FlatSignal<int> signal;
+  Consumer c1;
+  Consumer c2;
+
+  Connection connection = signal.Connect(&c1, &Consumer::OnRecord);
+  signal.Connect(&c2, &Consumer::OnRecord);
+
+  connection.Block();
+  signal(1);
+  signal.Block();
+  signal(2);
+  signal.Unblock();
+  connection.Unblock();
+  signal(3);
+
+  ASSERT_TRUE((c1.record_ == std::vector<int>{3}) && (c2.record_ == std::vector<int>{1, 3}));
+}
+
+/*
+ * SignalBlocker restores the state before it in the destructor
+ */
+TEST_F(Test, signal_blocker) {
+  Signal<int> signal;
+  Consumer c;
+
+  Connection connection = signal.Connect(&c, &Consumer::OnRecord);
+
+  {
+    SignalBlocker blocker1(signal);
+    signal(1);
+    {
+      SignalBlocker blocker2(signal);
+      blocker2.Unblock();
+      ASSERT_TRUE(signal.IsBlocked());  // blocked by blocker1
+      blocker2.Reblock();
+    }
+    ASSERT_TRUE(signal.IsBlocked());
+    blocker1.Unblock();
+    signal(2);
+    blocker1.Reblock();
+    signal(3);
+  }
+  signal(4);
+
+  {
+    SignalBlocker blocker(connection);
+    signal(5);
+  }
+  signal(6);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{2, 4, 6}) && !signal.IsBlocked() && !connection.IsBlocked());
+}
@@ -0,0 +1,281 @@
+// Unit test code for emitting chained signals
+
+#include "test.hpp"
+
+#include <sigcxx/flat_signal.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(int n, SLOT /* slot */) {
+    record_.push_back(n);
+  }
+
+  void OnRecordSignal(int /* n */, SLOT slot) {
+    signals_.push_back(slot->signal<int>());
+  }
+
+  void OnCheckSignalType(int /* n */, SLOT slot) {
+    record_.push_back(slot->signal<int>() != nullptr);
+    record_.push_back(slot->signal<double>() != nullptr);
+    record_.push_back(slot->signal<>() != nullptr);
+  }
+
+  void OnUnbindOther(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    other_->UnbindAllSignals();
+  }
+
+  void OnDeleteSignal(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    delete signal_;
+    signal_ = nullptr;
+  }
+
+  void OnUnbindSelf(int n, SLOT slot) {
+    record_.push_back(n);
+    UnbindSignal(slot);
+  }
+
+  void OnConnect(int n, SLOT /* slot */) {
+    record_.push_back(n);
+    if (nullptr != signal_) {
+      signal_->Connect(this, &Consumer::OnRecord);
+      signal_ = nullptr;
+    }
+  }
+
+  std::vector<int> record_;
+  std::vector<Signal<int> *> signals_;
+  Consumer *other_ = nullptr;
+  Signal<int> *signal_ = nullptr;
+};
+
+/*
+ * Slots in a tree of chained signals are called in the same order as
+ * emitting each signal in turn
+ */
+TEST_F(Test, call_order) {
+  Signal<int> s0;
+  Signal<int> s1;
+  Signal<int> s2;
+  Consumer c;
+
+  s2.Connect(&c, &Consumer::OnRecord);
+  s1.Connect(&c, &Consumer::OnRecord);
+  s1.Connect(s2);
+  s0.Connect(&c, &Consumer::OnRecord);
+  s0.Connect(s1);
+  s0.Connect(&c, &Consumer::OnRecord);
+
+  s0(0);
+  s1(1);
+  s2(2);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{0, 0, 0, 0, 1, 1, 2}));
+}
+
+/*
+ * Connections in chained signals are updated after the first emission
+ */
+TEST_F(Test, connect_after_emit) {
+  Signal<int> s0;
+  Signal<int> s1;
+  Signal<int> s2;
+  Consumer c;
+
+  s0.Connect(s1);
+  s1.Connect(s2);
+  s2.Connect(&c, &Consumer::OnRecord);
+  s0(0);
+
+  s2.Connect(&c, &Consumer::OnRecord);
+  s1.Connect(&c, &Consumer::OnRecord, 0);
+  s0(1);
+
+  s1.Disconnect(s2);
+  s0(2);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{0, 1, 1, 1, 2}));
+}
+
+/*
+ * Slot::signal() returns the signal the slot is connected to
+ */
+TEST_F(Test, slot_signal) {
+  Signal<int> s0;
+  Signal<int> s1;
+  Consumer c;
+
+  s0.Connect(&c, &Consumer::OnRecordSignal);
+  s0.Connect(s1);
+  s1.Connect(&c, &Consumer::OnRecordSignal);
+
+  s0(0);
+
+  ASSERT_TRUE((c.signals_ == std::vector<Signal<int> *>{&s0, &s1}));
+}
+
+/*
+ * Slot::signal() returns nullptr if the parameter types are different or
+ * the slot is called by a FlatSignal
+ */
+TEST_F(Test, slot_signal_type) {
+  Signal<int> s0;
+  FlatSignal<int> s1;
+  Consumer c;
+
+  s0.Connect(&c, &Consumer::OnCheckSignalType);
+  s1.Connect(&c, &Consumer::OnCheckSignalType);
+
+  s0(0);
+  s1(0);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1, 0, 0, 0, 0, 0}));
+}
+
+/*
+ * Connections removed in a slot method are not called
+ */
+TEST_F(Test, unbind_on_fire) {
+  Signal<int> s0;
+  Signal<int> s1;
+  Consumer c1;
+  Consumer c2;
+  c1.other_ = &c2;
+
+  s0.Connect(s1);
+  s1.Connect(&c1, &Consumer::OnUnbindOther);
+  s1.Connect(&c2, &Consumer::OnRecord);
+  s0.Connect(&c2, &Consumer::OnRecord);
+
+  s0(0);
+  s0(1);
+
+  ASSERT_TRUE((c1.record_ == std::vector<int>{0, 1}) && c2.record_.empty() &&
+      s1.CountConnections() == 1);
+}
+
+/*
+ * Delete a chained signal in a slot method
+ */
+TEST_F(Test, delete_chained_signal_on_fire) {
+  Signal<int> s0;
+  auto *s1 = new Signal<int>;
+  Consumer c;
+  c.signal_ = s1;
+
+  s0.Connect(*s1);
+  s0.Connect(&c, &Consumer::OnRecord);
+  s1->Connect(&c, &Consumer::OnDeleteSignal);
+  s1->Connect(&c, &Consumer::OnRecord);
+
+  s0(0);
+  s0(1);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{0, 0, 1}) && s0.CountConnections() == 1);
+}
+
+/*
+ * Delete the signal being emitted in a slot method of a chained signal, no
+ * more slot method is called
+ */
+TEST_F(Test, delete_root_signal_on_fire) {
+  auto *s0 = new Signal<int>;
+  Signal<int> s1;
+  Consumer c;
+  c.signal_ = s0;
+
+  s0->Connect(s1);
+  s0->Connect(&c, &Consumer::OnRecord);
+  s1.Connect(&c, &Consumer::OnDeleteSignal);
+  s1.Connect(&c, &Consumer::OnRecord);
+
+  s0->Emit(0);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{0}) && s1.CountSignalBindings() == 0);
+}
+
+/*
+ * Connections added while emitting chained signals are called from the next
+ * emission
+ */
+TEST_F(Test, connect_on_fire) {
+  Signal<int> s0;
+  Signal<int> s1;
+  Consumer c;
+  c.signal_ = &s1;
+
+  s0.Connect(s1);
+  s1.Connect(&c, &Consumer::OnConnect);
+
+  s0(0);
+  s0(1);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{0, 1, 1}));
+}
+
+/*
+ * Without chained signals a connection added after the current one is
+ * called in the same emission, with chained signals the emission goes
+ * through the dispatch list and a connection added to the root is called
+ * from the next emission, as documented on Emit()
+ */
+TEST_F(Test, connect_on_fire_to_root) {
+  Signal<int> plain;
+  Signal<int> s0;
+  Signal<int> s1;
+  Consumer c1;
+  Consumer c2;
+  c1.signal_ = &plain;
+  c2.signal_ = &s0;
+
+  plain.Connect(&c1, &Consumer::OnConnect);
+  plain(0);
+  ASSERT_TRUE((c1.record_ == std::vector<int>{0, 0}));
+
+  s0.Connect(s1);
+  s0.Connect(&c2, &Consumer::OnConnect);
+  s0(0);
+  s0(1);
+  ASSERT_TRUE((c2.record_ == std::vector<int>{0, 1, 1}));
+}
+
+/*
+ * Every slot method of a large fan-out behind a chained signal removes its
+ * own connection, each one is called once
+ */
+TEST_F(Test, unbind_self_on_fire) {
+  const int num = 1000;
+  Signal<int> s0;
+  Signal<int> s1;
+  std::vector<Consumer> consumers(num);
+
+  s0.Connect(s1);
+  for (Consumer &c : consumers) s1.Connect(&c, &Consumer::OnUnbindSelf);
+
+  s0(0);
+  s0(1);
+
+  ASSERT_TRUE(s1.CountConnections() == 0);
+  for (const Consumer &c : consumers) {
+    ASSERT_TRUE((c.record_ == std::vector<int>{0}));
+  }
+}
@@ -91,3 +91,38 @@ TEST_F(Test, IsConnectedTo3) {
       s2.signal1().IsConnectedTo(&o2) &&
       s3.signal1().IsConnectedTo(&o3));
 }
+
+/*
+ * The counts are kept on every path removing a connection
+ */
+TEST_F(Test, count_after_removal) {
+  Subject s;
+  sigcxx::Signal<int> chained;
+  Observer o1;
+  auto *o2 = new Observer;
+
+  ASSERT_TRUE(s.signal1().empty() && s.signal1().CountBindings() == 0);
+
+  s.signal1().Connect(&o1, &Observer::OnTest1IntegerParam);
+  s.signal1().Connect(o2, &Observer::OnTest1IntegerParam);
+  s.signal1().Connect(chained);
+  chained.Connect(&o1, &Observer::OnTest1IntegerParam);
+  chained.Connect(o2, &Observer::OnTest1IntegerParam);
+
+  ASSERT_TRUE(s.signal1().CountConnections() == 3 && chained.CountConnections() == 2 &&
+      chained.CountSignalBindings() == 1 && o1.CountSignalBindings() == 2 && o2->CountSignalBindings() == 2);
+
+  delete o2;
+  ASSERT_TRUE(s.signal1().CountConnections() == 2 && chained.CountConnections() == 1);
+
+  s.signal1().Disconnect(chained);
+  ASSERT_TRUE(s.signal1().CountConnections() == 1 && chained.CountSignalBindings() == 0);
+
+  s.signal0().Connect(&o1, &Observer::OnTestUnbindOnceAt5);
+  for (int i = 0; i < 6; i++) s.emit_signal0();
+  ASSERT_TRUE(s.signal0().empty() && o1.CountSignalBindings() == 2);
+
+  s.signal1().DisconnectAll();
+  chained.DisconnectAll();
+  ASSERT_TRUE(s.signal1().empty() && chained.empty() && o1.CountSignalBindings() == 0);
+}
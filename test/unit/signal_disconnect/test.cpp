@@ -2,6 +2,7 @@
 
 #include "test.hpp"
 #include <iostream>
+#include <vector>
 
 #include <subject.hpp>
 #include <observer.hpp>
@@ -275,3 +276,44 @@ TEST_F(Test, disconnect_no_check_4) {
 
   ASSERT_TRUE(s.signal1().CountConnections() == 0 && o.CountSignalBindings() == 0);
 }
+
+/*
+ * DisconnectAll() on a signal with many connections and chained signals,
+ * the signal can be used again after that
+ */
+TEST_F(Test, disconnect_all_many) {
+  sigcxx::Signal<int> upstream;
+  sigcxx::Signal<int> signal;
+  sigcxx::Signal<int> chained;
+  Observer o1;
+  Observer o2;
+
+  upstream.Connect(signal);
+  std::vector<sigcxx::Connection> connections;
+  for (int i = 0; i < 100; i++) {
+    connections.push_back(signal.Connect(&o1, &Observer::OnTest1IntegerParam));
+  }
+  signal.Connect(chained);
+  chained.Connect(&o2, &Observer::OnTest1IntegerParam);
+  upstream(1);
+
+  signal.DisconnectAll();
+  upstream(2);
+
+  bool cleared = true;
+  for (sigcxx::Connection &c : connections) cleared = cleared && !c.IsConnected();
+
+  ASSERT_TRUE(cleared && signal.CountConnections() == 0 && o1.CountSignalBindings() == 0 &&
+      chained.CountSignalBindings() == 0 && o1.test1_count() == 100 && o2.test1_count() == 1);
+
+  for (int i = 0; i < 40; i++) signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+  signal.Connect(&o2, &Observer::OnTest1IntegerParam, 20);
+  upstream(3);
+
+  ASSERT_TRUE(signal.CountConnections() == 41 &&
+      signal.CountConnections(&o2, &Observer::OnTest1IntegerParam) == 1 &&
+      o1.test1_count() == 140 && o2.test1_count() == 2);
+
+  signal.Disconnect(20, 1);
+  ASSERT_TRUE(o2.CountSignalBindings() == 1 && chained.CountConnections() == 1);
+}
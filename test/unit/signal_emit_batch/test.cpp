@@ -0,0 +1,142 @@
+// Unit test code for Signal::EmitBatch
+
+#include "test.hpp"
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  typedef std::tuple<int, std::string> TupleType;
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(int n, const std::string &str, SLOT /* slot */) {
+    record_.push_back(str + std::to_string(n));
+  }
+
+  void OnBatch(TupleType *tuples, size_t count, SLOT /* slot */) {
+    batch_sizes_.push_back(count);
+    for (size_t i = 0; i < count; i++) {
+      record_.push_back(std::get<1>(tuples[i]) + std::to_string(std::get<0>(tuples[i])));
+    }
+  }
+
+  void OnUnbindAt(int n, const std::string & /* str */, SLOT slot) {
+    record_.push_back(std::to_string(n));
+    if (n == unbind_at_) UnbindSignal(slot);
+  }
+
+  void OnDeleteSignal(int /* n */, const std::string & /* str */, SLOT /* slot */) {
+    record_.push_back("delete");
+    delete signal_;
+  }
+
+  std::vector<std::string> record_;
+  std::vector<size_t> batch_sizes_;
+  int unbind_at_ = -1;
+  Signal<int, const std::string &> *signal_ = nullptr;
+};
+
+/*
+ * Slots are called for all tuples one after another
+ */
+TEST_F(Test, slot_major) {
+  Signal<int, const std::string &> signal;
+  Consumer c1;
+  Consumer c2;
+
+  signal.Connect(&c1, &Consumer::OnRecord);
+  signal.Connect(&c2, &Consumer::OnRecord);
+  signal.Connect(&c1, &Consumer::OnRecord);
+
+  std::string a("a");
+  std::string b("b");
+  std::tuple<int, const std::string &> tuples[] = {std::make_tuple(1, std::cref(a)),
+                                                   std::make_tuple(2, std::cref(b))};
+  signal.EmitBatch(tuples, 2);
+
+  ASSERT_TRUE((c1.record_ == std::vector<std::string>{"a1", "b2", "a1", "b2"}) &&
+      (c2.record_ == std::vector<std::string>{"a1", "b2"}));
+}
+
+/*
+ * A batch slot is called once by EmitBatch() and with one tuple by Emit()
+ */
+TEST_F(Test, batch_slot) {
+  Signal<int, std::string> signal;
+  Consumer c;
+
+  signal.ConnectBatch(&c, &Consumer::OnBatch);
+
+  Consumer::TupleType tuples[] = {Consumer::TupleType(1, "a"),
+                                  Consumer::TupleType(2, "b"),
+                                  Consumer::TupleType(3, "c")};
+  signal.EmitBatch(tuples, 3);
+  signal.Emit(4, "d");
+
+  ASSERT_TRUE((c.record_ == std::vector<std::string>{"a1", "b2", "c3", "d4"}) &&
+      (c.batch_sizes_ == std::vector<size_t>{3, 1}));
+
+  ASSERT_TRUE(signal.IsConnectedTo(&c, &Consumer::OnBatch) &&
+      signal.CountConnections(&c, &Consumer::OnBatch) == 1 &&
+      c.CountSignalBindings(&Consumer::OnBatch) == 1);
+
+  signal.DisconnectAll(&c, &Consumer::OnBatch);
+  ASSERT_TRUE(signal.CountConnections() == 0 && c.CountSignalBindings() == 0);
+}
+
+/*
+ * A connection removed in the batch is not called for the remaining tuples
+ */
+TEST_F(Test, unbind_in_batch) {
+  Signal<int, const std::string &> signal;
+  Consumer c1;
+  Consumer c2;
+  c1.unbind_at_ = 1;
+
+  signal.Connect(&c1, &Consumer::OnUnbindAt);
+  signal.Connect(&c2, &Consumer::OnUnbindAt);
+
+  std::string str;
+  std::tuple<int, const std::string &> tuples[] = {std::make_tuple(0, std::cref(str)),
+                                                   std::make_tuple(1, std::cref(str)),
+                                                   std::make_tuple(2, std::cref(str))};
+  signal.EmitBatch(tuples, 3);
+
+  ASSERT_TRUE((c1.record_ == std::vector<std::string>{"0", "1"}) &&
+      (c2.record_ == std::vector<std::string>{"0", "1", "2"}) &&
+      signal.CountConnections() == 1);
+}
+
+/*
+ * The signal can be deleted in the batch
+ */
+TEST_F(Test, delete_signal_in_batch) {
+  Consumer c;
+  c.signal_ = new Signal<int, const std::string &>;
+
+  c.signal_->Connect(&c, &Consumer::OnDeleteSignal);
+  c.signal_->Connect(&c, &Consumer::OnRecord);
+
+  std::string str;
+  std::tuple<int, const std::string &> tuples[] = {std::make_tuple(0, std::cref(str)),
+                                                   std::make_tuple(1, std::cref(str))};
+  c.signal_->EmitBatch(tuples, 2);
+
+  ASSERT_TRUE((c.record_ == std::vector<std::string>{"delete"}) && c.CountSignalBindings() == 0);
+}
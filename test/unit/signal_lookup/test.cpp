@@ -0,0 +1,190 @@
+// Unit test code for finding connections by object and method
+
+#include "test.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord1(int /* n */, SLOT /* slot */) {
+    record_->push_back(id_);
+  }
+
+  void OnRecord2(int /* n */, SLOT /* slot */) {
+    record_->push_back(-id_);
+  }
+
+  int id_ = 0;
+  std::vector<int> *record_ = nullptr;
+};
+
+/*
+ * Connect 500 slots to 50 consumers in a random order, record the ids in a
+ * vector in the same order
+ */
+static void ConnectRandom(Signal<int> *signal, std::vector<Consumer> *consumers, std::vector<int> *model) {
+  for (size_t i = 0; i < 500; i++) {
+    int id = std::rand() % static_cast<int>(consumers->size());
+    if (std::rand() % 2) {
+      signal->Connect(&(*consumers)[id], &Consumer::OnRecord1);
+      model->push_back(id + 1);
+    } else {
+      signal->Connect(&(*consumers)[id], &Consumer::OnRecord2);
+      model->push_back(-id - 1);
+    }
+  }
+}
+
+static std::vector<Consumer> *NewConsumers(std::vector<int> *record) {
+  auto *consumers = new std::vector<Consumer>(50);
+  for (size_t i = 0; i < consumers->size(); i++) {
+    (*consumers)[i].id_ = static_cast<int>(i) + 1;
+    (*consumers)[i].record_ = record;
+  }
+  return consumers;
+}
+
+/*
+ * IsConnectedTo() and CountConnections() of a signal with many connections
+ */
+TEST_F(Test, count_connections) {
+  Signal<int> signal;
+  std::vector<int> record;
+  std::vector<int> model;
+  std::vector<Consumer> *consumers = NewConsumers(&record);
+
+  std::srand(1);
+  ConnectRandom(&signal, consumers, &model);
+
+  for (int id = 1; id <= 50; id++) {
+    Consumer *c = &(*consumers)[id - 1];
+    int count1 = static_cast<int>(std::count(model.begin(), model.end(), id));
+    int count2 = static_cast<int>(std::count(model.begin(), model.end(), -id));
+
+    ASSERT_TRUE(signal.CountConnections(c, &Consumer::OnRecord1) == count1 &&
+        signal.CountConnections(c, &Consumer::OnRecord2) == count2 &&
+        signal.IsConnectedTo(c, &Consumer::OnRecord1) == (count1 > 0) &&
+        signal.IsConnectedTo(c, &Consumer::OnRecord2) == (count2 > 0));
+  }
+
+  delete consumers;
+  ASSERT_TRUE(signal.CountConnections() == 0);
+}
+
+/*
+ * DisconnectAll() removes only the connections to the method
+ */
+TEST_F(Test, disconnect_all) {
+  Signal<int> signal;
+  std::vector<int> record;
+  std::vector<int> model;
+  std::vector<Consumer> *consumers = NewConsumers(&record);
+
+  std::srand(2);
+  ConnectRandom(&signal, consumers, &model);
+
+  for (int id = 1; id <= 50; id += 3) {
+    signal.DisconnectAll(&(*consumers)[id - 1], &Consumer::OnRecord1);
+    model.erase(std::remove(model.begin(), model.end(), id), model.end());
+  }
+
+  signal(0);
+
+  ASSERT_TRUE(record == model && signal.CountConnections() == static_cast<int>(model.size()));
+
+  delete consumers;
+}
+
+/*
+ * Disconnect() from start positions in both directions removes the same
+ * connections as walking the list
+ */
+TEST_F(Test, disconnect_at_positions) {
+  Signal<int> signal;
+  std::vector<int> record;
+  std::vector<int> model;
+  std::vector<Consumer> *consumers = NewConsumers(&record);
+
+  std::srand(3);
+  ConnectRandom(&signal, consumers, &model);
+
+  for (int i = 0; i < 200; i++) {
+    int id = std::rand() % 50 + 1;
+    int count = static_cast<int>(model.size());
+    int start_pos = std::rand() % (2 * count + 2) - count - 1;
+    int counts = std::rand() % 3;
+
+    int removed = signal.Disconnect(&(*consumers)[id - 1], &Consumer::OnRecord2, start_pos, counts);
+
+    int expected = 0;
+    if (start_pos >= 0) {
+      for (int j = start_pos; j < static_cast<int>(model.size()); j++) {
+        if (model[j] == -id) {
+          model.erase(model.begin() + j--);
+          expected++;
+          if (expected == counts) break;
+        }
+      }
+    } else {
+      for (int j = count + start_pos; j >= 0; j--) {
+        if (model[j] == -id) {
+          model.erase(model.begin() + j);
+          expected++;
+          if (expected == counts) break;
+        }
+      }
+    }
+
+    ASSERT_TRUE(removed == expected);
+  }
+
+  signal(0);
+
+  ASSERT_TRUE(record == model && signal.CountConnections() == static_cast<int>(model.size()));
+
+  delete consumers;
+}
+
+/*
+ * The index is kept when observers are destroyed and connections are added
+ * again
+ */
+TEST_F(Test, auto_disconnect) {
+  Signal<int> signal;
+  std::vector<int> record;
+  Consumer c;
+  c.id_ = 1;
+  c.record_ = &record;
+
+  for (int i = 0; i < 3; i++) {
+    std::vector<Consumer> *consumers = NewConsumers(&record);
+    for (Consumer &other : *consumers) {
+      signal.Connect(&other, &Consumer::OnRecord1);
+      signal.Connect(&c, &Consumer::OnRecord2);
+    }
+    delete consumers;
+
+    ASSERT_TRUE(signal.CountConnections() == 50 * (i + 1) &&
+        signal.CountConnections(&c, &Consumer::OnRecord2) == 50 * (i + 1));
+  }
+
+  signal.DisconnectAll(&c, &Consumer::OnRecord2);
+  ASSERT_TRUE(signal.CountConnections() == 0 && c.CountSignalBindings() == 0);
+}
@@ -0,0 +1,162 @@
+// Unit test code for connecting and disconnecting at positions
+
+#include "test.hpp"
+
+#include <cstdlib>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(int /* n */, SLOT /* slot */) {
+    record_->push_back(id_);
+  }
+
+  int id_ = 0;
+  std::vector<int> *record_ = nullptr;
+};
+
+/*
+ * Insert the same position into a std::vector
+ */
+static void InsertAt(std::vector<int> *model, int id, int index) {
+  int count = static_cast<int>(model->size());
+  int position = count;
+  if (index >= 0) {
+    if (index < count) position = index;
+  } else {
+    position = count + index + 1;
+    if (position < 0) position = 0;
+  }
+  model->insert(model->begin() + position, id);
+}
+
+/*
+ * Connect at random positions, the order of slots is the same as the order
+ * in a vector
+ */
+TEST_F(Test, connect_at_positions) {
+  Signal<int> signal;
+  std::vector<Consumer> consumers(200);
+  std::vector<int> model;
+  std::vector<int> record;
+
+  std::srand(1);
+  for (size_t i = 0; i < consumers.size(); i++) {
+    consumers[i].id_ = static_cast<int>(i);
+    consumers[i].record_ = &record;
+
+    int index = std::rand() % (2 * static_cast<int>(i) + 3) - static_cast<int>(i) - 1;
+    signal.Connect(&consumers[i], &Consumer::OnRecord, index);
+    InsertAt(&model, static_cast<int>(i), index);
+  }
+
+  signal(0);
+
+  ASSERT_TRUE(record == model && signal.CountConnections() == 200);
+}
+
+/*
+ * Disconnect from random start positions in both directions, the remaining
+ * slots are the same as the ones in a vector
+ */
+TEST_F(Test, disconnect_at_positions) {
+  Signal<int> signal;
+  std::vector<Consumer> consumers(100);
+  std::vector<int> model;
+  std::vector<int> record;
+
+  for (size_t i = 0; i < consumers.size(); i++) {
+    consumers[i].id_ = static_cast<int>(i % 10);
+    consumers[i].record_ = &record;
+    signal.Connect(&consumers[i % 10], &Consumer::OnRecord);
+    model.push_back(static_cast<int>(i % 10));
+  }
+
+  std::srand(2);
+  for (int i = 0; i < 60; i++) {
+    int id = std::rand() % 10;
+    int count = static_cast<int>(model.size());
+    int start_pos = std::rand() % (2 * count + 2) - count - 1;
+
+    int removed = signal.Disconnect(&consumers[id], &Consumer::OnRecord, start_pos, 1);
+
+    int expected = 0;
+    if (start_pos >= 0) {
+      for (int j = start_pos; j < count; j++) {
+        if (model[j] == id) {
+          model.erase(model.begin() + j);
+          expected = 1;
+          break;
+        }
+      }
+    } else {
+      for (int j = count + start_pos; j >= 0; j--) {
+        if (model[j] == id) {
+          model.erase(model.begin() + j);
+          expected = 1;
+          break;
+        }
+      }
+    }
+
+    ASSERT_TRUE(removed == expected);
+  }
+
+  signal(0);
+
+  ASSERT_TRUE(record == model && signal.CountConnections() == static_cast<int>(model.size()));
+}
+
+/*
+ * The connections are still in order after the observers are destroyed
+ */
+TEST_F(Test, auto_disconnect) {
+  Signal<int> signal;
+  std::vector<Consumer *> consumers;
+  std::vector<int> record;
+
+  for (int i = 0; i < 100; i++) {
+    auto *c = new Consumer;
+    c->id_ = i;
+    c->record_ = &record;
+    consumers.push_back(c);
+    signal.Connect(c, &Consumer::OnRecord);
+  }
+
+  std::vector<int> model;
+  for (int i = 0; i < 100; i++) {
+    if (i % 3 == 0) {
+      delete consumers[i];
+    } else {
+      model.push_back(i);
+    }
+  }
+
+  signal.Connect(consumers[1], &Consumer::OnRecord, 50);
+  model.insert(model.begin() + 50, 1);
+
+  signal(0);
+
+  ASSERT_TRUE(record == model && signal.CountConnections() == static_cast<int>(model.size()));
+
+  for (int i = 0; i < 100; i++) {
+    if (i % 3 != 0) delete consumers[i];
+  }
+
+  ASSERT_TRUE(signal.CountConnections() == 0);
+}
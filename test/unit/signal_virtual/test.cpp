@@ -21,7 +21,7 @@ TEST_F(Test, connect_method_once) {
   signal2.Connect(obj2, &SubConsumer::OnVirtualTest); // this signal_connect to the method in sub class
 
   sigcxx::Signal<int> signal3;
-  signal3.Connect(dynamic_cast<Consumer *>(obj2),
+  signal3.Connect(static_cast<Consumer *>(obj2),
                  &Consumer::OnVirtualTest); // this still signal_connect to the method in sub class
 
   signal1.Emit(1);
@@ -44,7 +44,7 @@ TEST_F(Test, connect_to_pure_virtual_function) {
 
   signal1.Emit(1);
 
-  size_t result = dynamic_cast<Consumer *>(obj1)->virtualtest_count();
+  size_t result = static_cast<Consumer *>(obj1)->virtualtest_count();
 
   delete obj1;
 
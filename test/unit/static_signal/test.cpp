@@ -0,0 +1,173 @@
+// Unit test code for StaticSignal
+
+#include "test.hpp"
+
+#include <observer.hpp>
+
+#include <sigcxx/static_signal.hpp>
+
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+using namespace sigcxx;
+
+static size_t new_count = 0;
+
+void *operator new(size_t size) {
+  new_count++;
+  void *p = std::malloc(size);
+  if (nullptr == p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void *p, size_t /* size */) noexcept {
+  std::free(p);
+}
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {}
+
+  void OnRecord(int n, SLOT /* slot */) {
+    record_.push_back(n);
+  }
+
+  void OnUnbind(int n, SLOT slot) {
+    record_.push_back(n);
+    UnbindSignal(slot);
+  }
+
+  void OnReconnect(int n, SLOT slot) {
+    record_.push_back(n);
+    UnbindSignal(slot);
+    signal_->Connect(this, &Consumer::OnRecord);
+  }
+
+  void OnDestroy(int /* n */, SLOT /* slot */) {
+    delete this;
+  }
+
+  std::vector<int> record_;
+  StaticSignal<4, int> *signal_ = nullptr;
+};
+
+/*
+ * Connect and disconnect does not allocate memory
+ */
+TEST_F(Test, no_allocation) {
+  StaticSignal<4, int> signal;
+  Signal<int> chained;
+  Observer o1;
+  Observer o2;
+
+  size_t count = new_count;
+
+  for (int i = 0; i < 100; i++) {
+    signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+    signal.Connect(&o2, &Observer::OnTest1IntegerParam);
+    signal.Connect(chained);
+    signal.Connect(&o1, &Observer::OnTest1IntegerParam, 0);
+    signal.Disconnect(&o1, &Observer::OnTest1IntegerParam);
+    signal.DisconnectAll(chained);
+    signal.DisconnectAll();
+  }
+
+  ASSERT_TRUE(new_count == count && signal.CountConnections() == 0 &&
+      o1.CountSignalBindings() == 0 && o2.CountSignalBindings() == 0);
+}
+
+/*
+ * Emit calls slots in order, chained signals work in both directions
+ */
+TEST_F(Test, emit) {
+  StaticSignal<4, int> signal;
+  Signal<int> chained;
+  StaticSignal<1, int> chained_static;
+  Observer o;
+
+  signal.Connect(&o, &Observer::OnTest1IntegerParam);
+  signal.Connect(chained);
+  chained.Connect(chained_static);
+  chained_static.Connect(&o, &Observer::OnTest1IntegerParam);
+
+  signal(1);
+
+  ASSERT_TRUE(o.test1_count() == 2 && signal.IsConnectedTo(chained) &&
+      chained.IsConnectedTo(chained_static) && o.CountSignalBindings() == 2);
+}
+
+/*
+ * Connections are removed when the observer is destroyed, and the cells can
+ * be reused
+ */
+TEST_F(Test, auto_disconnect) {
+  StaticSignal<2, int> signal;
+  Observer o1;
+
+  for (int i = 0; i < 10; i++) {
+    auto *o2 = new Observer;
+    signal.Connect(&o1, &Observer::OnTest1IntegerParam);
+    signal.Connect(o2, &Observer::OnTest1IntegerParam);
+    signal(i);
+    delete o2;
+    signal.Disconnect(&o1, &Observer::OnTest1IntegerParam);
+  }
+
+  ASSERT_TRUE(signal.CountConnections() == 0 && o1.test1_count() == 10);
+}
+
+/*
+ * Bindings in observers are removed when the signal is destroyed
+ */
+TEST_F(Test, delete_signal) {
+  Observer o;
+  Signal<int> chained;
+
+  {
+    StaticSignal<3, int> signal;
+    signal.Connect(&o, &Observer::OnTest1IntegerParam);
+    signal.Connect(&o, &Observer::OnTest1IntegerParam);
+    chained.Connect(signal);
+    signal.Connect(chained);
+  }
+
+  ASSERT_TRUE(o.CountSignalBindings() == 0 && chained.CountConnections() == 0 &&
+      chained.CountSignalBindings() == 0);
+}
+
+/*
+ * Connections can be broken, added, or the observer can be deleted while
+ * emitting
+ */
+TEST_F(Test, modify_on_fire) {
+  StaticSignal<4, int> signal;
+  Consumer c;
+  auto *obj = new Consumer;
+  c.signal_ = &signal;
+
+  signal.Connect(&c, &Consumer::OnUnbind);
+  signal.Connect(obj, &Consumer::OnDestroy);
+  signal.Connect(&c, &Consumer::OnReconnect);
+  signal.Connect(&c, &Consumer::OnRecord);
+
+  signal(1);
+  signal(2);
+
+  ASSERT_TRUE((c.record_ == std::vector<int>{1, 1, 1, 1, 2, 2}) && signal.CountConnections() == 2);
+}
@@ -0,0 +1,301 @@
+// Unit test code for threading policies of Signal and Trackable
+
+#include "test.hpp"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+template<typename Policy>
+class Consumer : public BasicTrackable<Policy> {
+ public:
+
+  Consumer() {}
+
+  virtual ~Consumer() {
+    // Wait for the emissions calling this object before sum_ is gone
+    this->UnbindAllSignals();
+  }
+
+  void OnCount(int n, SLOT /* slot */) {
+    sum_ += n;
+  }
+
+  void OnUnbind(int n, SLOT slot) {
+    sum_ += n;
+    this->UnbindSignal(slot);
+  }
+
+  void OnConnect(int n, SLOT /* slot */) {
+    sum_ += n;
+    signal_->Connect(this, &Consumer::OnCount);
+  }
+
+  void UnbindAll() {
+    this->UnbindAllSignalsTo(&Consumer::OnCount);
+  }
+
+  std::atomic<int> sum_{0};
+  BasicSignal<Policy, int> *signal_ = nullptr;
+};
+
+/*
+ * Connect, emit and disconnect a locked signal in one thread
+ */
+template<typename Policy>
+static void ConnectAndDisconnect() {
+  BasicSignal<Policy, int> s0;
+  BasicSignal<Policy, int> s1;
+  Consumer<Policy> c1;
+  auto *c2 = new Consumer<Policy>;
+
+  s0.Connect(&c1, &Consumer<Policy>::OnCount);
+  s0.Connect(c2, &Consumer<Policy>::OnCount);
+  s0.Connect(s1);
+  s1.Connect(&c1, &Consumer<Policy>::OnUnbind);
+
+  s0(1);
+  ASSERT_TRUE(c1.sum_ == 2 && c2->sum_ == 1 && s0.CountConnections() == 3 && s1.empty() &&
+      s1.CountSignalBindings() == 1 && c1.CountSignalBindings() == 1);
+
+  delete c2;
+  ASSERT_TRUE(s0.CountConnections() == 2 && s0.IsConnectedTo(s1));
+
+  s0.Connect(&c1, &Consumer<Policy>::OnCount);
+  ASSERT_TRUE(s0.Disconnect(0, 2) == 2 && s0.CountConnections() == 1 &&
+      s0.CountConnections(&c1, &Consumer<Policy>::OnCount) == 1 && s1.CountSignalBindings() == 0);
+
+  s0.DisconnectAll();
+  ASSERT_TRUE(s0.empty() && c1.CountSignalBindings() == 0);
+}
+
+TEST_F(Test, single_threaded) {
+  ASSERT_TRUE((std::is_same<BasicTrackable<SingleThreaded>, Trackable>::value));
+  ASSERT_TRUE((std::is_same<BasicSignal<SingleThreaded, int>, Signal<int>>::value));
+  ASSERT_TRUE((std::is_same<BasicConnection<SingleThreaded>, Connection>::value));
+  ConnectAndDisconnect<SingleThreaded>();
+}
+
+/*
+ * A locked signal cannot be used through the unlocked base class
+ */
+TEST_F(Test, not_convertible) {
+  ASSERT_TRUE((!std::is_convertible<BasicSignal<SpinLock, int> *, Signal<int> *>::value));
+  ASSERT_TRUE((!std::is_convertible<BasicSignal<MutexLock, int> &, SignalRef<int>>::value));
+  ASSERT_TRUE((!std::is_convertible<BasicSignal<MutexLock, int> *, Trackable *>::value));
+  ASSERT_TRUE((!std::is_convertible<BasicConnection<SpinLock> *, Connection *>::value));
+}
+
+TEST_F(Test, connect_and_disconnect) {
+  ConnectAndDisconnect<SpinLock>();
+  ConnectAndDisconnect<MutexLock>();
+}
+
+/*
+ * The connection handle of a locked signal disconnects and blocks with the
+ * locks held, slot methods can connect to the signal emitting them
+ */
+template<typename Policy>
+static void ConnectionHandle() {
+  BasicSignal<Policy, int> signal;
+  Consumer<Policy> c;
+  c.signal_ = &signal;
+
+  BasicConnection<Policy> connection = signal.Connect(&c, &Consumer<Policy>::OnConnect);
+  signal(1);
+  ASSERT_TRUE(c.sum_ == 2 && signal.CountConnections() == 2);
+
+  connection.Block();
+  signal(1);
+  ASSERT_TRUE(c.sum_ == 3 && signal.CountConnections() == 2);
+
+  BasicScopedConnection<Policy> scoped(std::move(connection));
+  {
+    BasicScopedConnection<Policy> discard(std::move(scoped));
+  }
+  ASSERT_TRUE(!connection && signal.CountConnections() == 1 && c.CountSignalBindings() == 1);
+
+  // A handle outliving its signal forgets the lock
+  auto *other = new BasicSignal<Policy, int>;
+  connection = other->Connect(&c, &Consumer<Policy>::OnCount);
+  delete other;
+  connection.Block();
+  connection.Disconnect();
+  ASSERT_TRUE(!connection && c.CountSignalBindings() == 1);
+}
+
+TEST_F(Test, connection_handle) {
+  ConnectionHandle<SpinLock>();
+  ConnectionHandle<MutexLock>();
+}
+
+/*
+ * Observers are destroyed in several threads while another thread keeps
+ * emitting, destroying an observer waits for the emission calling it
+ */
+template<typename Policy>
+static void EmitWhileDestroying() {
+  const int num = 4;
+  const int loops = 1000;
+  BasicSignal<Policy, int> signal;
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num; i++) {
+    threads.emplace_back([&signal]() {
+      for (int j = 0; j < loops; j++) {
+        std::unique_ptr<Consumer<Policy>> c(new Consumer<Policy>);
+        signal.Connect(c.get(), &Consumer<Policy>::OnCount);
+      }
+    });
+  }
+
+  std::thread emitter([&signal, &done]() {
+    while (!done) signal(1);
+  });
+
+  for (std::thread &t : threads) t.join();
+  done = true;
+  emitter.join();
+
+  ASSERT_TRUE(signal.empty());
+}
+
+TEST_F(Test, emit_while_destroying) {
+  EmitWhileDestroying<SpinLock>();
+  EmitWhileDestroying<MutexLock>();
+}
+
+/*
+ * Observers are connected and destroyed in several threads while the signal
+ * removes connections by position in another
+ */
+template<typename Policy>
+static void DestroyObservers() {
+  const int num = 4;
+  const int loops = 2000;
+  BasicSignal<Policy, int> signal;
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num; i++) {
+    threads.emplace_back([&signal]() {
+      for (int j = 0; j < loops; j++) {
+        std::unique_ptr<Consumer<Policy>> c(new Consumer<Policy>);
+        signal.Connect(c.get(), &Consumer<Policy>::OnCount);
+        signal.Connect(c.get(), &Consumer<Policy>::OnCount);
+      }
+    });
+  }
+
+  std::thread remover([&signal, &done]() {
+    while (!done) signal.Disconnect(0, 1);
+  });
+
+  for (std::thread &t : threads) t.join();
+  done = true;
+  remover.join();
+
+  ASSERT_TRUE(signal.empty());
+}
+
+TEST_F(Test, destroy_observers) {
+  DestroyObservers<SpinLock>();
+  DestroyObservers<MutexLock>();
+}
+
+/*
+ * Two signals chained to each other are connected and disconnected from both
+ * ends at the same time, the locks are taken in both orders
+ */
+template<typename Policy>
+static void ChainBothWays() {
+  const int loops = 5000;
+  BasicSignal<Policy, int> s0;
+  BasicSignal<Policy, int> s1;
+
+  std::thread t0([&s0, &s1]() {
+    for (int i = 0; i < loops; i++) {
+      s0.Connect(s1);
+      s0.DisconnectAll();
+    }
+  });
+
+  std::thread t1([&s0, &s1]() {
+    for (int i = 0; i < loops; i++) {
+      s1.Connect(s0);
+      s0.Connect(s1);
+      s1.DisconnectAll();
+    }
+  });
+
+  std::thread t2([&s0, &s1]() {
+    for (int i = 0; i < loops; i++) {
+      s1.Connect(s0);
+      s0.CountSignalBindings();
+      s1.DisconnectAll(s0);
+    }
+  });
+
+  t0.join();
+  t1.join();
+  t2.join();
+
+  s0.DisconnectAll();
+  ASSERT_TRUE(s0.empty() && s1.empty() && s0.CountSignalBindings() == 0 && s1.CountSignalBindings() == 0);
+}
+
+TEST_F(Test, chain_both_ways) {
+  ChainBothWays<SpinLock>();
+  ChainBothWays<MutexLock>();
+}
+
+/*
+ * Signals connected to one observer are destroyed in several threads while
+ * the observer unbinds itself
+ */
+template<typename Policy>
+static void DestroySignals() {
+  const int num = 4;
+  const int loops = 2000;
+  Consumer<Policy> c;
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> threads;
+  for (int i = 0; i < num; i++) {
+    threads.emplace_back([&c]() {
+      for (int j = 0; j < loops; j++) {
+        BasicSignal<Policy, int> signal;
+        signal.Connect(&c, &Consumer<Policy>::OnCount);
+        signal.Connect(&c, &Consumer<Policy>::OnCount);
+      }
+    });
+  }
+
+  std::thread unbinder([&c, &done]() {
+    while (!done) c.UnbindAll();
+  });
+
+  for (std::thread &t : threads) t.join();
+  done = true;
+  unbinder.join();
+
+  ASSERT_TRUE(c.CountSignalBindings() == 0);
+}
+
+TEST_F(Test, destroy_signals) {
+  DestroySignals<SpinLock>();
+  DestroySignals<MutexLock>();
+}
@@ -0,0 +1,19 @@
+// Unit test code for Event::connect
+
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <sigcxx/threading.hpp>
+
+class Test: public testing::Test
+{
+ public:
+  Test ();
+  virtual ~Test();
+
+ protected:
+  virtual void SetUp() {  }
+  virtual void TearDown() {  }
+};
+
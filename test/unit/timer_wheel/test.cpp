@@ -0,0 +1,164 @@
+// Unit test code for TimerWheel
+
+#include "test.hpp"
+
+#include <memory>
+#include <vector>
+
+using namespace sigcxx;
+
+Test::Test()
+    : testing::Test() {
+}
+
+Test::~Test() {
+
+}
+
+class Consumer : public Trackable {
+ public:
+
+  explicit Consumer(TimerWheel *wheel = nullptr)
+      : wheel_(wheel) {}
+
+  virtual ~Consumer() {}
+
+  void OnTimeout(SLOT /* slot */) {
+    fired_at_.push_back(wheel_->now());
+  }
+
+  void OnRestart(SLOT /* slot */) {
+    fired_at_.push_back(wheel_->now());
+    if (fired_at_.size() < 3) timer_->Restart();
+  }
+
+  void OnDeleteTimer(SLOT /* slot */) {
+    fired_at_.push_back(wheel_->now());
+    delete timer_;
+    timer_ = nullptr;
+  }
+
+  TimerWheel *wheel_;
+  Timer *timer_ = nullptr;
+  std::vector<uint64_t> fired_at_;
+};
+
+/*
+ * Each timer expires at its tick, in any level of the wheel
+ */
+TEST_F(Test, expire_at_tick) {
+  const uint64_t delays[] = {0, 1, 2, 255, 256, 257, 1000, 16383, 16384, 16385, 100000, (1 << 20) + 3};
+  TimerWheel wheel;
+  Consumer c(&wheel);
+  std::vector<std::unique_ptr<Timer>> timers;
+
+  wheel.Advance(12345);  // not aligned to any level
+  for (uint64_t delay : delays) {
+    timers.emplace_back(new Timer);
+    timers.back()->timeout().Connect(&c, &Consumer::OnTimeout);
+    timers.back()->Start(wheel, delay);
+  }
+  ASSERT_TRUE(wheel.CountTimers() == timers.size());
+
+  ASSERT_TRUE(wheel.Advance((1 << 20) + 10) == timers.size());
+  ASSERT_TRUE(c.fired_at_.size() == timers.size() && wheel.CountTimers() == 0);
+  for (size_t i = 0; i < c.fired_at_.size(); i++) {
+    ASSERT_TRUE(c.fired_at_[i] == 12345 + (delays[i] > 0 ? delays[i] : 1));
+  }
+}
+
+/*
+ * Stopped timers do not expire, restarted ones expire from the new start
+ */
+TEST_F(Test, stop_and_restart) {
+  TimerWheel wheel;
+  Consumer c(&wheel);
+  Timer t1;
+  Timer t2;
+
+  t1.timeout().Connect(&c, &Consumer::OnTimeout);
+  t2.timeout().Connect(&c, &Consumer::OnTimeout);
+  t1.Start(wheel, 10);
+  t2.Start(wheel, 300);
+
+  wheel.Advance(5);
+  t1.Stop();
+  t2.Restart();
+  ASSERT_TRUE(!t1.IsActive() && t2.IsActive() && t2.expires() == 305 && wheel.CountTimers() == 1);
+
+  wheel.Advance(1000);
+  ASSERT_TRUE((c.fired_at_ == std::vector<uint64_t>{305}) && !t2.IsActive());
+}
+
+/*
+ * Slot methods can restart their timer and destroy timers
+ */
+TEST_F(Test, change_in_slot) {
+  TimerWheel wheel;
+  Consumer periodic(&wheel);
+  Consumer deleting(&wheel);
+  Timer t1;
+
+  periodic.timer_ = &t1;
+  t1.timeout().Connect(&periodic, &Consumer::OnRestart);
+  t1.Start(wheel, 100);
+
+  deleting.timer_ = new Timer;
+  deleting.timer_->timeout().Connect(&deleting, &Consumer::OnDeleteTimer);
+  deleting.timer_->Start(wheel, 100);
+
+  wheel.Advance(1000);
+  ASSERT_TRUE((periodic.fired_at_ == std::vector<uint64_t>{100, 200, 300}));
+  ASSERT_TRUE((deleting.fired_at_ == std::vector<uint64_t>{100}) && nullptr == deleting.timer_);
+}
+
+/*
+ * Destroying observers disconnects them, destroying timers or the wheel
+ * stops the timers
+ */
+TEST_F(Test, auto_disconnect) {
+  auto *wheel = new TimerWheel;
+  auto *c = new Consumer(wheel);
+  Timer t1;
+  auto *t2 = new Timer;
+
+  t1.timeout().Connect(c, &Consumer::OnTimeout);
+  t1.Start(*wheel, 10);
+  t2->Start(*wheel, 10);
+  delete c;
+  delete t2;
+
+  ASSERT_TRUE(wheel->CountTimers() == 1 && wheel->Advance(20) == 1);
+
+  t1.Start(*wheel, 10);
+  delete wheel;
+  ASSERT_TRUE(!t1.IsActive());
+}
+
+/*
+ * Poll() advances by the ticks passed since the wheel was created
+ */
+TEST_F(Test, poll) {
+  TimerWheel wheel(std::chrono::milliseconds(10));
+  Timer t1;
+
+  t1.Start(wheel, 5);
+  ASSERT_TRUE(wheel.Poll(TimerWheel::Clock::now() + std::chrono::milliseconds(100)) == 1);
+  ASSERT_TRUE(wheel.now() >= 10 && wheel.Poll(TimerWheel::Clock::now() - std::chrono::seconds(1)) == 0);
+}
+
+/*
+ * A timer in the last level is moved down through all levels
+ */
+TEST_F(Test, last_level) {
+  TimerWheel wheel;
+  Consumer c(&wheel);
+  Timer t1;
+
+  wheel.Advance(77);
+  t1.timeout().Connect(&c, &Consumer::OnTimeout);
+  t1.Start(wheel, (uint64_t(1) << 26) + 7);
+
+  wheel.Advance(uint64_t(1) << 27);
+  ASSERT_TRUE((c.fired_at_ == std::vector<uint64_t>{77 + (uint64_t(1) << 26) + 7}));
+}
@@ -2,6 +2,8 @@
 
 #include "test.hpp"
 #include <iostream>
+#include <memory>
+#include <vector>
 
 #include <subject.hpp>
 #include <observer.hpp>
@@ -186,3 +188,36 @@ TEST_F(Test, unbind_all_method_in_callback) {
       (s1.signal0().CountConnections() == 4) &&
       (s2.signal0().CountConnections() == 0));
 }
+
+/*
+ * Unbind an observer connected many times to many signals, and to a signal
+ * it is emitted by
+ */
+TEST_F(Test, unbind_all_many) {
+  const int num = 50;
+  std::unique_ptr<sigcxx::Signal<int>[]> signals(new sigcxx::Signal<int>[num]);
+  Observer o1;
+  Observer o2;
+  std::vector<sigcxx::Connection> connections;
+
+  for (int i = 0; i < num; i++) {
+    for (int j = 0; j < 3; j++) {
+      connections.push_back(signals[i].Connect(&o1, &Observer::OnTest1IntegerParam));
+    }
+    signals[i].Connect(&o2, &Observer::OnTest1IntegerParam);
+  }
+
+  o1.unbind_all();
+
+  bool cleared = true;
+  for (sigcxx::Connection &c : connections) cleared = cleared && !c.IsConnected();
+
+  for (int i = 0; i < num; i++) signals[i](i);
+
+  ASSERT_TRUE(cleared && o1.CountSignalBindings() == 0 && o1.test1_count() == 0 &&
+      o2.CountSignalBindings() == num && o2.test1_count() == num);
+
+  signals[0].Connect(&o1, &Observer::OnTest1IntegerParam);
+  signals[0](0);
+  ASSERT_TRUE(signals[0].CountConnections() == 2 && o1.test1_count() == 1);
+}